@@ -30,8 +30,27 @@
 #define POINTING_DEVICE_INVERT_Y
 
 #ifdef POINTING_DEVICE_ENABLE
-// Automatically enable the pointer layer when moving the trackball.  See also:
-// - `CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_TIMEOUT_MS`
-// - `CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_THRESHOLD`
+// Automatically enable the pointer layer when moving the trackball.  See also
+// users/jobe/auto_pointer.h:
+// - `AUTO_POINTER_ENTER_THRESHOLD` / `AUTO_POINTER_EXIT_THRESHOLD`
+// - `AUTO_POINTER_RATE_CAP`
+// - `AUTO_POINTER_DECAY_SHIFT`
+// - `AUTO_POINTER_TIMEOUT_MS`
 // #define CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
+
+// Velocity-based pointer acceleration, curve picked per layer in keymap.c.
+// See users/jobe/pointer_accel.h.
+#define POINTER_ACCEL_ENABLE
+
+// Smooth drag-scroll with momentum, replaces the driver's own on DRGSCRL.
+// See users/jobe/drag_scroll.h.
+#define DRAG_SCROLL_ENABLE
+#define DRAG_SCROLL_MOMENTUM
+#define POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#define WHEEL_EXTENDED_REPORT
+
+// Read the sensor every millisecond and send the summed motion once per USB
+// poll, however long the main loop takes.  See users/jobe/pointer_batch.h.
+#define POINTING_DEVICE_TASK_THROTTLE_MS 1
+#define POINTER_BATCH_ENABLE
 #endif // POINTING_DEVICE_ENABLE
@@ -16,10 +16,21 @@
  */
 #include QMK_KEYBOARD_H
 #include "utils.h" // Include custom definitions
+#include "layer_dispatch.h"
+#include "hot_path.h"
 
 #ifdef CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
-#    include "timer.h"
+#    include "auto_pointer.h"
 #endif // CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
+#ifdef POINTER_ACCEL_ENABLE
+#    include "pointer_accel.h"
+#endif // POINTER_ACCEL_ENABLE
+#ifdef DRAG_SCROLL_ENABLE
+#    include "drag_scroll.h"
+#endif // DRAG_SCROLL_ENABLE
+#ifdef POINTER_BATCH_ENABLE
+#    include "pointer_batch.h"
+#endif // POINTER_BATCH_ENABLE
 
 enum charybdis_keymap_layers {
     LAYER_BASE = 0,
@@ -34,18 +45,6 @@ enum charybdis_keymap_layers {
 // Automatically enable sniping-mode on the pointer layer.
 #define CHARYBDIS_AUTO_SNIPING_ON_LAYER LAYER_POINTER
 
-#ifdef CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
-static uint16_t auto_pointer_layer_timer = 0;
-
-#    ifndef CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_TIMEOUT_MS
-#        define CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_TIMEOUT_MS 1000
-#    endif // CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_TIMEOUT_MS
-
-#    ifndef CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_THRESHOLD
-#        define CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_THRESHOLD 8
-#    endif // CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_THRESHOLD
-#endif     // CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
-
 #define ESC_MED LT(LAYER_MEDIA, KC_ESC)
 #define SPC_NAV LT(LAYER_NAVIGATION, KC_SPC)
 #define TAB_FUN LT(LAYER_FUNCTION, KC_TAB)
@@ -218,39 +217,72 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
 // clang-format on
 
 #ifdef POINTING_DEVICE_ENABLE
-#    ifdef CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
-report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
-    if (abs(mouse_report.x) > CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_THRESHOLD || abs(mouse_report.y) > CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_THRESHOLD) {
-        if (auto_pointer_layer_timer == 0) {
-            layer_on(LAYER_POINTER);
-#        ifdef RGB_MATRIX_ENABLE
-            rgb_matrix_mode_noeeprom(RGB_MATRIX_NONE);
-            rgb_matrix_sethsv_noeeprom(HSV_GREEN);
-#        endif // RGB_MATRIX_ENABLE
-        }
-        auto_pointer_layer_timer = timer_read();
-    }
-    return mouse_report;
+void keyboard_post_init_user(void) {
+    dpi_ladder_init();
 }
 
-void matrix_scan_user(void) {
-    if (auto_pointer_layer_timer != 0 && TIMER_DIFF_16(timer_read(), auto_pointer_layer_timer) >= CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_TIMEOUT_MS) {
-        auto_pointer_layer_timer = 0;
-        layer_off(LAYER_POINTER);
-#        ifdef RGB_MATRIX_ENABLE
-        rgb_matrix_mode_noeeprom(RGB_MATRIX_DEFAULT_MODE);
-#        endif // RGB_MATRIX_ENABLE
-    }
+#    ifdef POINTER_ACCEL_ENABLE
+/** \brief Acceleration curve of each layer; sniping already slows the pointer layer down. */
+static const uint8_t PROGMEM pointer_accel_layer_curves[] = {
+    [LAYER_BASE]       = POINTER_ACCEL_DEFAULT,
+    [LAYER_FUNCTION]   = POINTER_ACCEL_DEFAULT,
+    [LAYER_NAVIGATION] = POINTER_ACCEL_DEFAULT,
+    [LAYER_MEDIA]      = POINTER_ACCEL_DEFAULT,
+    [LAYER_POINTER]    = POINTER_ACCEL_LINEAR,
+    [LAYER_NUMERAL]    = POINTER_ACCEL_DEFAULT,
+    [LAYER_SYMBOLS]    = POINTER_ACCEL_DEFAULT,
+};
+#    endif // POINTER_ACCEL_ENABLE
+
+#    if defined(CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE) || defined(POINTER_ACCEL_ENABLE) || defined(DRAG_SCROLL_ENABLE) || defined(POINTER_BATCH_ENABLE)
+HOT_PATH report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
+#        ifdef CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
+    // Triggered on raw sensor motion.  Layer colours follow through layer_state_set_user.
+    auto_pointer_task(&mouse_report, LAYER_POINTER);
+#        endif // CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
+#        ifdef DRAG_SCROLL_ENABLE
+    // Takes x/y while scrolling, so acceleration only sees pointer motion
+    drag_scroll_task(&mouse_report);
+#        endif // DRAG_SCROLL_ENABLE
+#        ifdef POINTER_ACCEL_ENABLE
+    pointer_accel_task(&mouse_report, pgm_read_byte(&pointer_accel_layer_curves[get_highest_layer(layer_state)]));
+#        endif // POINTER_ACCEL_ENABLE
+#        ifdef POINTER_BATCH_ENABLE
+    // Last, so everything above still works on single sensor reads
+    pointer_batch_task(&mouse_report);
+#        endif // POINTER_BATCH_ENABLE
+    return mouse_report;
 }
-#    endif // CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
+#    endif // CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE || POINTER_ACCEL_ENABLE || DRAG_SCROLL_ENABLE || POINTER_BATCH_ENABLE
 
 #    ifdef CHARYBDIS_AUTO_SNIPING_ON_LAYER
 layer_state_t layer_state_set_user(layer_state_t state) {
+    // Each side effect only runs when its own input changes, see layer_dispatch.h
+    layer_transition_t transition;
+    if (!layer_dispatch_begin(state, &transition)) {
+        return state;
+    }
+
     // Original auto-sniping logic
-    charybdis_set_pointer_sniping_enabled(layer_state_cmp(state, CHARYBDIS_AUTO_SNIPING_ON_LAYER));
+    static uint8_t sniping     = LAYER_DISPATCH_UNSET;
+    bool           sniping_off = false;
+    if (layer_dispatch_changed(&sniping, layer_state_cmp(state, CHARYBDIS_AUTO_SNIPING_ON_LAYER))) {
+        charybdis_set_pointer_sniping_enabled(sniping);
+        // That resets the CPI to the default DPI, even under a higher layer
+        sniping_off = !sniping;
+    }
+    // Then the layer's own rung of the DPI ladder, see utils.h
+    static uint8_t dpi_layer = LAYER_DISPATCH_UNSET;
+    if (layer_dispatch_changed(&dpi_layer, transition.highest) || sniping_off) {
+        dpi_ladder_layer_changed(state);
+    }
 
     // Add layer indicator logic
-    switch (get_highest_layer(state)) {
+    static uint8_t rgb_layer = LAYER_DISPATCH_UNSET;
+    if (!layer_dispatch_changed(&rgb_layer, transition.highest)) {
+        return state;
+    }
+    switch (transition.highest) {
         case LAYER_BASE:
             // Set color for base layer (e.g., white)
             rgb_matrix_set_color_all(HSV_WHITE);
@@ -0,0 +1,131 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "matrix_bulk.h"
+#include "matrix.h"
+#include "hot_path.h"
+#include "print.h"
+
+#if !defined(MATRIX_BULK_READ_PORT)
+#    if defined(MCU_RP)
+#        include "hardware/structs/sio.h"
+// The column pins keep a low output latch, so enabling the driver selects them.
+#        define MATRIX_BULK_READ_PORT()    (sio_hw->gpio_in)
+#        define MATRIX_BULK_SELECT(mask)   (sio_hw->gpio_oe_set = (mask))
+#        define MATRIX_BULK_UNSELECT(mask) (sio_hw->gpio_oe_clr = (mask))
+#        define MATRIX_BULK_PIN_BIT(pin)   ((uint32_t)1 << PAL_PAD(pin))
+#    else
+#        error "The bulk matrix scan needs MATRIX_BULK_READ_PORT and friends on this MCU"
+#    endif // MCU_RP
+#endif // MATRIX_BULK_READ_PORT
+
+#define MATRIX_BULK_COLS (sizeof(bulk_col_pins) / sizeof(bulk_col_pins[0]))
+
+static const pin_t bulk_row_pins[] = MATRIX_ROW_PINS;
+static const pin_t bulk_col_pins[] = MATRIX_COL_PINS;
+#if defined(SPLIT_KEYBOARD) && defined(MATRIX_ROW_PINS_RIGHT)
+static const pin_t bulk_row_pins_right[] = MATRIX_ROW_PINS_RIGHT;
+static const pin_t bulk_col_pins_right[] = MATRIX_COL_PINS_RIGHT;
+#endif // SPLIT_KEYBOARD && MATRIX_ROW_PINS_RIGHT
+
+_Static_assert(sizeof(bulk_row_pins) / sizeof(bulk_row_pins[0]) == ROWS_PER_HAND, "MATRIX_ROW_PINS does not match ROWS_PER_HAND");
+_Static_assert(MATRIX_BULK_COLS <= sizeof(matrix_row_t) * 8, "matrix_row_t too narrow for MATRIX_COL_PINS");
+
+// Port bit of each pin of this half, and all the row bits together.
+static uint32_t bulk_row_bits[ROWS_PER_HAND];
+static uint32_t bulk_col_bits[MATRIX_BULK_COLS];
+static uint32_t bulk_row_mask;
+
+static uint32_t bulk_window_start;
+static uint32_t bulk_window_scans;
+
+matrix_bulk_stats_t matrix_bulk_stats;
+
+void matrix_init_custom(void) {
+    const pin_t *row_pins = bulk_row_pins;
+    const pin_t *col_pins = bulk_col_pins;
+#if defined(SPLIT_KEYBOARD) && defined(MATRIX_ROW_PINS_RIGHT)
+    if (!is_keyboard_left()) {
+        row_pins = bulk_row_pins_right;
+        col_pins = bulk_col_pins_right;
+    }
+#endif // SPLIT_KEYBOARD && MATRIX_ROW_PINS_RIGHT
+
+    bulk_row_mask = 0;
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        gpio_set_pin_input_high(row_pins[row]);
+        bulk_row_bits[row] = MATRIX_BULK_PIN_BIT(row_pins[row]);
+        bulk_row_mask |= bulk_row_bits[row];
+    }
+    for (uint8_t col = 0; col < MATRIX_BULK_COLS; col++) {
+        gpio_set_pin_input_high(col_pins[col]);
+        gpio_write_pin_low(col_pins[col]);
+        bulk_col_bits[col] = MATRIX_BULK_PIN_BIT(col_pins[col]);
+    }
+    bulk_window_start = timer_read32();
+}
+
+static HOT_PATH void bulk_count_scan(bool changed) {
+    matrix_bulk_stats.scans++;
+    matrix_bulk_stats.changes += changed;
+    bulk_window_scans++;
+
+    uint32_t now = timer_read32();
+    if (now - bulk_window_start >= 1000) {
+        matrix_bulk_stats.rate = bulk_window_scans;
+        bulk_window_scans      = 0;
+        bulk_window_start      = now;
+        if (debug_matrix) {
+            uprintf("matrix scan rate: %lu/s\n", (unsigned long)matrix_bulk_stats.rate);
+        }
+    }
+}
+
+HOT_PATH bool matrix_scan_custom(matrix_row_t current_matrix[]) {
+    matrix_row_t next[ROWS_PER_HAND] = {0};
+
+    for (uint8_t col = 0; col < MATRIX_BULK_COLS; col++) {
+        MATRIX_BULK_SELECT(bulk_col_bits[col]);
+        wait_cpuclock(MATRIX_BULK_SETTLE_CYCLES);
+        uint32_t low = ~MATRIX_BULK_READ_PORT() & bulk_row_mask;
+        MATRIX_BULK_UNSELECT(bulk_col_bits[col]);
+        if (!low) {
+            continue;
+        }
+
+        for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+            if (low & bulk_row_bits[row]) {
+                next[row] |= (matrix_row_t)1 << col;
+            }
+        }
+
+        // Pressed keys held their rows down through the diodes, let the pull-ups win before the next column
+        uint16_t spins = 0;
+        while ((MATRIX_BULK_READ_PORT() & bulk_row_mask) != bulk_row_mask && spins < MATRIX_BULK_RECOVER_SPINS) {
+            spins++;
+        }
+        if (spins > matrix_bulk_stats.recover_worst) {
+            matrix_bulk_stats.recover_worst = spins;
+        }
+    }
+
+    bool changed = memcmp(current_matrix, next, sizeof(next)) != 0;
+    if (changed) {
+        memcpy(current_matrix, next, sizeof(next));
+    }
+    bulk_count_scan(changed);
+    return changed;
+}
@@ -0,0 +1,58 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+/**
+ * \brief Matrix scan reading a whole column in one GPIO register read.
+ *
+ * The diodes point from rows to columns, so each column is pulled low in
+ * turn and every row is sampled with a single read of the GPIO input
+ * register; the row bits are picked out of that word with masks worked out
+ * once at init.  A column with nothing pressed costs one compare.  After a
+ * column with a key down, the rows are polled until they are back high
+ * instead of waiting a fixed `MATRIX_IO_DELAY`.
+ *
+ * Enabled with `CUSTOM_MATRIX = lite` in rules.mk.  On the RP2040 the
+ * port is driven through the SIO registers; elsewhere, or to run the scan
+ * against a fake register, define all of `MATRIX_BULK_READ_PORT()`,
+ * `MATRIX_BULK_SELECT(mask)`, `MATRIX_BULK_UNSELECT(mask)` and
+ * `MATRIX_BULK_PIN_BIT(pin)`, as users/jobe/tests/test_matrix_bulk.c does.
+ */
+
+#ifndef MATRIX_BULK_SETTLE_CYCLES
+#    define MATRIX_BULK_SETTLE_CYCLES (CPU_CLOCK / 1000000L / 4) // ~250 ns for the selected column to pull the rows down.
+#endif // MATRIX_BULK_SETTLE_CYCLES
+
+#ifndef MATRIX_BULK_RECOVER_SPINS
+#    define MATRIX_BULK_RECOVER_SPINS 4096 // Bound on the wait for the rows to float back high.
+#endif // MATRIX_BULK_RECOVER_SPINS
+
+typedef struct {
+    uint32_t scans;         // Since boot.
+    uint32_t changes;       // Scans that saw a key change.
+    uint32_t rate;          // Scans in the last full second.
+    uint16_t recover_worst; // Most polls spent waiting for the rows to recover.
+} matrix_bulk_stats_t;
+
+/**
+ * \brief Scan counters.
+ *
+ * With `debug_matrix` on, the scan rate is also printed once per second.
+ */
+extern matrix_bulk_stats_t matrix_bulk_stats;
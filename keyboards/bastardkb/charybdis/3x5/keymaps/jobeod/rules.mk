@@ -2,3 +2,11 @@ VIA_ENABLE = yes
 RGB_MATRIX_ENABLE = yes # Enable RGB Matrix feature
 
 SRC += utils.c # Add custom source file
+DEFERRED_EXEC_ENABLE = yes # DPI ladder debounce and persistence
+
+# Whole-column GPIO reads instead of the pin by pin scan (matrix_bulk.h)
+CUSTOM_MATRIX = lite
+SRC += matrix_bulk.c
+
+# Shared code in users/jobe (auto pointer layer, ...)
+USER_NAME := jobe
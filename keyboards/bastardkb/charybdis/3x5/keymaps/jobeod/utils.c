@@ -1,43 +1,104 @@
 #include "utils.h" // Include custom definitions and declarations
+#include "hot_path.h"
+
+#ifdef DRAG_SCROLL_ENABLE
+#    include "drag_scroll.h"
+#endif // DRAG_SCROLL_ENABLE
+
+#ifdef POINTING_DEVICE_ENABLE
+#    define DPI_LADDER_STEPS  16
+#    define DPI_LADDER_LAYERS 8 // 4 bits per layer fill the 32-bit user EEPROM word
+
+// Roughly x1.3 per step, 200 to 12000 CPI
+static const uint16_t PROGMEM dpi_ladder[DPI_LADDER_STEPS] = {
+    200, 300, 400, 500, 600, 800, 1000, 1200, 1600, 2000, 2400, 3200, 4000, 5600, 8000, 12000,
+};
+
+// Rung of each layer, stored XORed with the default so a blank EEPROM reads as default
+static uint32_t       dpi_ladder_steps   = 0;
+static uint8_t        dpi_ladder_layer   = 0;
+static deferred_token dpi_ladder_apply   = INVALID_DEFERRED_TOKEN;
+static deferred_token dpi_ladder_persist = INVALID_DEFERRED_TOKEN;
+
+static uint8_t dpi_ladder_get_step(uint8_t layer) {
+    return ((dpi_ladder_steps >> (layer * 4)) & 0xF) ^ DPI_LADDER_DEFAULT_STEP;
+}
+
+static void dpi_ladder_set_step(uint8_t layer, uint8_t step) {
+    dpi_ladder_steps &= ~((uint32_t)0xF << (layer * 4));
+    dpi_ladder_steps |= (uint32_t)(step ^ DPI_LADDER_DEFAULT_STEP) << (layer * 4);
+}
+
+static uint32_t dpi_ladder_persist_callback(uint32_t trigger_time, void *cb_arg) {
+    eeconfig_update_user(dpi_ladder_steps);
+    dpi_ladder_persist = INVALID_DEFERRED_TOKEN;
+    return 0;
+}
+
+static uint32_t dpi_ladder_apply_callback(uint32_t trigger_time, void *cb_arg) {
+    // Sniping owns the sensor while it is on
+    if (!charybdis_get_pointer_sniping_enabled()) {
+        pointing_device_set_cpi(pgm_read_word(&dpi_ladder[dpi_ladder_get_step(dpi_ladder_layer)]));
+    }
+    dpi_ladder_apply = INVALID_DEFERRED_TOKEN;
+    return 0;
+}
+
+// Write the sensor once the presses stop coming in
+static void dpi_ladder_schedule(uint32_t delay_ms) {
+    if (dpi_ladder_apply == INVALID_DEFERRED_TOKEN || !extend_deferred_exec(dpi_ladder_apply, delay_ms)) {
+        dpi_ladder_apply = defer_exec(delay_ms, dpi_ladder_apply_callback, NULL);
+    }
+}
+
+void dpi_ladder_init(void) {
+    dpi_ladder_steps = eeconfig_read_user();
+    dpi_ladder_schedule(1);
+}
+
+void dpi_ladder_layer_changed(layer_state_t state) {
+    uint8_t layer = get_highest_layer(state);
+    dpi_ladder_layer = layer < DPI_LADDER_LAYERS ? layer : 0;
+    dpi_ladder_schedule(1);
+}
+
+static void dpi_ladder_step(int8_t direction) {
+    uint8_t step = dpi_ladder_get_step(dpi_ladder_layer);
+    if ((direction > 0 && step == DPI_LADDER_STEPS - 1) || (direction < 0 && step == 0)) {
+        return;
+    }
+    dpi_ladder_set_step(dpi_ladder_layer, step + direction);
+    dpi_ladder_schedule(DPI_LADDER_DEBOUNCE_MS);
+
+    if (dpi_ladder_persist == INVALID_DEFERRED_TOKEN || !extend_deferred_exec(dpi_ladder_persist, DPI_LADDER_PERSIST_MS)) {
+        dpi_ladder_persist = defer_exec(DPI_LADDER_PERSIST_MS, dpi_ladder_persist_callback, NULL);
+    }
+}
+#endif // POINTING_DEVICE_ENABLE
 
 // Handle custom keycodes for DPI adjustment
-bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+HOT_PATH bool process_record_user(uint16_t keycode, keyrecord_t *record) {
 #ifdef POINTING_DEVICE_ENABLE
-    if (record->event.pressed) { // Only process on key press
-        uint16_t current_cpi = pointing_device_get_cpi();
-        uint16_t new_cpi = current_cpi;
-        uint16_t cpi_step = 100; // How much to change DPI by each step
-        // Define sensor limits (adjust if needed for your specific sensor)
-        uint16_t min_cpi = 100;
-        uint16_t max_cpi = 12000;
-
-        switch (keycode) {
-            case DPI_INC:
-                new_cpi = current_cpi + cpi_step;
-                if (new_cpi > max_cpi) {
-                    new_cpi = max_cpi; // Clamp to max
-                }
-                if (new_cpi != current_cpi) {
-                    pointing_device_set_cpi(new_cpi);
-                    // Optional: print CPI to console for debugging
-                    // printf("CPI set to: %u\n", new_cpi);
-                }
-                return false; // Skip default processing
-
-            case DPI_DEC:
-                if (current_cpi > min_cpi + cpi_step) {
-                     new_cpi = current_cpi - cpi_step;
-                } else {
-                     new_cpi = min_cpi; // Clamp to min
-                }
-                if (new_cpi != current_cpi) {
-                    pointing_device_set_cpi(new_cpi);
-                    // Optional: print CPI to console for debugging
-                    // printf("CPI set to: %u\n", new_cpi);
-                }
-                return false; // Skip default processing
-        }
+    switch (keycode) {
+        case DPI_INC:
+            if (record->event.pressed) {
+                dpi_ladder_step(+1);
+            }
+            return false; // Skip default processing
+
+        case DPI_DEC:
+            if (record->event.pressed) {
+                dpi_ladder_step(-1);
+            }
+            return false; // Skip default processing
+
+#    ifdef DRAG_SCROLL_ENABLE
+        case DRGSCRL:
+            // Momentary, the driver's own drag-scroll never engages
+            drag_scroll_set_enabled(record->event.pressed);
+            return false;
+#    endif // DRAG_SCROLL_ENABLE
     }
 #endif // POINTING_DEVICE_ENABLE
     return true; // Process other keycodes normally
-} 
\ No newline at end of file
+}
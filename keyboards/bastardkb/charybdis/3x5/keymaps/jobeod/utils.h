@@ -8,5 +8,27 @@ enum custom_keycodes {
     DPI_DEC,
 };
 
+// DPI_INC/DPI_DEC walk a geometric ladder of 16 CPI values, with one rung
+// remembered per layer (the first 8 layers).  Rapid presses coalesce into one
+// sensor write after DPI_LADDER_DEBOUNCE_MS, and the rungs are saved to the
+// user EEPROM word once DPI_LADDER_PERSIST_MS have passed without a change.
+#ifndef DPI_LADDER_DEBOUNCE_MS
+#    define DPI_LADDER_DEBOUNCE_MS 150
+#endif // DPI_LADDER_DEBOUNCE_MS
+
+#ifndef DPI_LADDER_PERSIST_MS
+#    define DPI_LADDER_PERSIST_MS 5000
+#endif // DPI_LADDER_PERSIST_MS
+
+#ifndef DPI_LADDER_DEFAULT_STEP
+#    define DPI_LADDER_DEFAULT_STEP 7 // 1200 CPI
+#endif // DPI_LADDER_DEFAULT_STEP
+
+// Load the saved rungs.  Call from keyboard_post_init_user.
+void dpi_ladder_init(void);
+
+// Apply the rung of the new top layer.  Call from layer_state_set_user.
+void dpi_ladder_layer_changed(layer_state_t state);
+
 // Declaration for the DPI adjustment function
-bool process_record_user(uint16_t keycode, keyrecord_t *record); 
\ No newline at end of file
+bool process_record_user(uint16_t keycode, keyrecord_t *record);
@@ -0,0 +1,20 @@
+RGB_MATRIX_EFFECT(LAYER_INDICATOR)
+#ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+
+HOT_PATH bool LAYER_INDICATOR(effect_params_t* params) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+
+    RGB_KERNEL_BENCH_BEGIN();
+
+    // Only the keys bound on the active layer are lit, see layer_indicator.h
+    if (params->iter == 0) {
+        layer_indicator_render(params->init);
+        rgb_kernel_limit_current();
+    }
+    rgb_kernel_flush(params, led_min, led_max);
+
+    RGB_KERNEL_BENCH_END(led_max);
+    return rgb_matrix_check_finished_leds(led_max);
+}
+
+#endif // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
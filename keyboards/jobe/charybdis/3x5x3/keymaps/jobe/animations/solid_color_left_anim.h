@@ -4,14 +4,20 @@ RGB_MATRIX_EFFECT(SOLID_COLOR_LEFT)
 bool SOLID_COLOR_LEFT(effect_params_t* params) {
     RGB_MATRIX_USE_LIMITS(led_min, led_max);
 
-    rgb_t rgb = rgb_matrix_hsv_to_rgb(rgb_matrix_config.hsv);
-    for (uint8_t i = led_min; i < led_max; i++) {
-        RGB_MATRIX_TEST_LED_FLAGS();
-        // Only set color for the left side (0 to RGBLED_NUM/2-1)
-        if (i < RGB_MATRIX_LED_COUNT / 2) {
-            rgb_matrix_set_color(i, rgb.r, rgb.g, rgb.b);
-        } 
+    RGB_KERNEL_BENCH_BEGIN();
+
+    // Only set color for the left side (0 to RGBLED_NUM/2-1)
+    if (params->iter == 0) {
+        rgb_kernel_fill(rgb_kernel_frame, rgb_kernel_hsv_to_rgb(rgb_matrix_config.hsv), RGB_MATRIX_LED_COUNT / 2);
+        rgb_kernel_limit_current();
+    }
+    uint8_t first = led_min;
+    uint8_t last  = led_max < RGB_MATRIX_LED_COUNT / 2 ? led_max : RGB_MATRIX_LED_COUNT / 2;
+    if (first < last) {
+        rgb_kernel_flush(params, first, last);
     }
+
+    RGB_KERNEL_BENCH_END(led_max);
     return rgb_matrix_check_finished_leds(led_max);
 }
 
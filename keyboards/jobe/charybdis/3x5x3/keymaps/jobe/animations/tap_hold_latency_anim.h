@@ -0,0 +1,22 @@
+RGB_MATRIX_EFFECT(TAP_HOLD_LATENCY)
+#ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+
+HOT_PATH bool TAP_HOLD_LATENCY(effect_params_t* params) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+    static uint8_t level = 0;
+
+    RGB_KERNEL_BENCH_BEGIN();
+
+    // SMTD keys only, green when decided at once, red when waiting on the tap term
+    if (params->iter == 0) {
+        tap_hold_stats_render(params->init || level != rgb_matrix_config.hsv.v);
+        level = rgb_matrix_config.hsv.v;
+        rgb_kernel_limit_current();
+    }
+    rgb_kernel_flush(params, led_min, led_max);
+
+    RGB_KERNEL_BENCH_END(led_max);
+    return rgb_matrix_check_finished_leds(led_max);
+}
+
+#endif // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
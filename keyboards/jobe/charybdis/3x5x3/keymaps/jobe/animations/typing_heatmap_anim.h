@@ -0,0 +1,45 @@
+RGB_MATRIX_EFFECT(TYPING_HEATMAP)
+#ifdef TYPING_HEATMAP_PERSIST
+RGB_MATRIX_EFFECT(TYPING_USAGE)
+#endif // TYPING_HEATMAP_PERSIST
+#ifdef RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+
+HOT_PATH bool TYPING_HEATMAP(effect_params_t* params) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+    static uint8_t level = 0;
+
+    RGB_KERNEL_BENCH_BEGIN();
+
+    // Only cells that are still warm are recomputed, see typing_heatmap.h
+    if (params->iter == 0) {
+        typing_heatmap_render(params->init || level != rgb_matrix_config.hsv.v);
+        level = rgb_matrix_config.hsv.v;
+        rgb_kernel_limit_current();
+    }
+    rgb_kernel_flush(params, led_min, led_max);
+
+    RGB_KERNEL_BENCH_END(led_max);
+    return rgb_matrix_check_finished_leds(led_max);
+}
+
+#    ifdef TYPING_HEATMAP_PERSIST
+HOT_PATH bool TYPING_USAGE(effect_params_t* params) {
+    RGB_MATRIX_USE_LIMITS(led_min, led_max);
+    static uint8_t level = 0;
+
+    RGB_KERNEL_BENCH_BEGIN();
+
+    // Cumulative press counts, kept across sessions
+    if (params->iter == 0) {
+        typing_heatmap_render_usage(params->init || level != rgb_matrix_config.hsv.v);
+        level = rgb_matrix_config.hsv.v;
+        rgb_kernel_limit_current();
+    }
+    rgb_kernel_flush(params, led_min, led_max);
+
+    RGB_KERNEL_BENCH_END(led_max);
+    return rgb_matrix_check_finished_leds(led_max);
+}
+#    endif // TYPING_HEATMAP_PERSIST
+
+#endif // RGB_MATRIX_CUSTOM_EFFECT_IMPLS
@@ -0,0 +1,209 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "combo_bits.h"
+#include "utils.h"
+#include "hot_path.h"
+#include "print.h"
+
+#define COMBO_BITS_POSITIONS 64
+#define COMBO_BITS_NONE      0xFF
+
+typedef struct {
+    uint64_t keys; // Keys of the combo still down.
+    uint16_t keycode;
+} combo_bits_active_t;
+
+combo_bits_stats_t combo_bits_stats;
+
+// RAM copies of the combos, and the combos each layout position is part of.
+static uint64_t combo_keys[COMBO_BITS_POSITIONS];
+static uint16_t combo_keycodes[COMBO_BITS_POSITIONS];
+static uint64_t combo_by_position[COMBO_BITS_POSITIONS];
+
+// Presses held back while they may still be a combo.
+static keyrecord_t    combo_buffer[COMBO_BITS_MAX_KEYS];
+static uint8_t        combo_buffered   = 0;
+static uint64_t       combo_pressed    = 0;
+static uint64_t       combo_candidates = 0;
+static deferred_token combo_timeout    = INVALID_DEFERRED_TOKEN;
+static bool           combo_replaying  = false;
+static uint16_t       combo_last_press = 0;
+
+static combo_bits_active_t combo_active[COMBO_BITS_MAX_ACTIVE];
+static uint64_t            combo_active_keys = 0;
+
+void combo_bits_init(void) {
+    uint8_t count = combo_bits_count < COMBO_BITS_POSITIONS ? combo_bits_count : COMBO_BITS_POSITIONS;
+    memset(combo_by_position, 0, sizeof(combo_by_position));
+    for (uint8_t i = 0; i < count; i++) {
+        memcpy_P(&combo_keys[i], &combo_bits[i].keys, sizeof(combo_keys[i]));
+        combo_keycodes[i] = pgm_read_word(&combo_bits[i].keycode);
+        for (uint64_t keys = combo_keys[i]; keys; keys &= keys - 1) {
+            combo_by_position[__builtin_ctzll(keys)] |= COMBO_BITS_KEY(i);
+        }
+    }
+}
+
+static HOT_PATH uint8_t combo_position(keyrecord_t *record) {
+    keypos_t key = record->event.key;
+    if (key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+        return COMBO_BITS_NONE;
+    }
+    uint8_t position = pgm_read_byte(&layout_positions[key.row][key.col]);
+    return position == 0 ? COMBO_BITS_NONE : position - 1;
+}
+
+static void combo_clear(void) {
+    if (combo_timeout != INVALID_DEFERRED_TOKEN) {
+        cancel_deferred_exec(combo_timeout);
+        combo_timeout = INVALID_DEFERRED_TOKEN;
+    }
+    combo_buffered   = 0;
+    combo_pressed    = 0;
+    combo_candidates = 0;
+}
+
+// Hand the held presses on, as they would have been without combos
+static void combo_replay(void) {
+    uint8_t buffered = combo_buffered;
+    combo_clear();
+    combo_replaying = true;
+    for (uint8_t i = 0; i < buffered; i++) {
+        process_record(&combo_buffer[i]);
+    }
+    combo_replaying = false;
+    combo_bits_stats.replayed += buffered;
+}
+
+// The candidate made of exactly the held keys
+static HOT_PATH uint8_t combo_exact(void) {
+    for (uint64_t candidates = combo_candidates; candidates; candidates &= candidates - 1) {
+        uint8_t combo = __builtin_ctzll(candidates);
+        combo_bits_stats.candidates++;
+        if (combo_keys[combo] == combo_pressed) {
+            return combo;
+        }
+    }
+    return COMBO_BITS_NONE;
+}
+
+static void combo_fire(uint8_t combo) {
+    for (uint8_t slot = 0; slot < COMBO_BITS_MAX_ACTIVE; slot++) {
+        if (combo_active[slot].keys == 0) {
+            combo_active[slot] = (combo_bits_active_t){.keys = combo_pressed, .keycode = combo_keycodes[combo]};
+            combo_active_keys |= combo_pressed;
+            combo_clear();
+            register_code16(combo_active[slot].keycode);
+            combo_bits_stats.fired++;
+            return;
+        }
+    }
+    combo_replay(); // Too many combos held
+}
+
+static uint32_t combo_timeout_callback(uint32_t trigger_time, void *cb_arg) {
+    combo_timeout = INVALID_DEFERRED_TOKEN;
+    uint8_t combo = combo_exact();
+    if (combo != COMBO_BITS_NONE) {
+        combo_fire(combo);
+    } else {
+        combo_replay();
+    }
+    return 0;
+}
+
+// First release of any key of an active combo releases its keycode
+static void combo_release(uint64_t bit) {
+    combo_active_keys &= ~bit;
+    for (uint8_t slot = 0; slot < COMBO_BITS_MAX_ACTIVE; slot++) {
+        if (!(combo_active[slot].keys & bit)) {
+            continue;
+        }
+        if (combo_active[slot].keycode != KC_NO) {
+            unregister_code16(combo_active[slot].keycode);
+            combo_active[slot].keycode = KC_NO;
+        }
+        combo_active[slot].keys &= ~bit;
+    }
+}
+
+HOT_PATH bool combo_bits_process(keyrecord_t *record) {
+    if (combo_replaying) {
+        return true;
+    }
+
+    // Any press while typing, combo key or not, keeps the next one from starting a combo
+    bool idle = true;
+    if (record->event.pressed) {
+        idle             = TIMER_DIFF_16(record->event.time, combo_last_press) >= COMBO_BITS_IDLE_MS;
+        combo_last_press = record->event.time;
+    }
+
+    uint8_t position = combo_position(record);
+    if (position == COMBO_BITS_NONE) {
+        if (combo_buffered) {
+            combo_replay();
+        }
+        return true;
+    }
+    uint64_t bit = COMBO_BITS_KEY(position);
+
+    if (!record->event.pressed) {
+        if (combo_active_keys & bit) {
+            combo_release(bit);
+            return false;
+        }
+        // Includes a held key going up before its combo was complete
+        if (combo_buffered) {
+            combo_replay();
+        }
+        return true;
+    }
+
+    if (combo_buffered) {
+        uint64_t candidates = combo_candidates & combo_by_position[position];
+        if (candidates && combo_buffered < COMBO_BITS_MAX_KEYS) {
+            combo_candidates = candidates;
+        } else {
+            // Not a combo after all, this press may start the next one
+            combo_replay();
+        }
+    }
+    if (!combo_buffered) {
+        // Fast path: keys without combos, presses in the middle of typing, and every key off the base layer
+        if (!combo_by_position[position] || !idle || get_highest_layer(layer_state | default_layer_state) != 0) {
+            return true;
+        }
+        combo_candidates = combo_by_position[position];
+        combo_timeout    = defer_exec(COMBO_BITS_TERM, combo_timeout_callback, NULL);
+    }
+
+    combo_buffer[combo_buffered++] = *record;
+    combo_pressed |= bit;
+    combo_bits_stats.held++;
+
+    // Fire early when no candidate needs more keys
+    uint8_t combo = combo_exact();
+    if (combo != COMBO_BITS_NONE && combo_candidates == COMBO_BITS_KEY(combo)) {
+        combo_fire(combo);
+    }
+    return false;
+}
+
+void combo_bits_report(void) {
+    uprintf("combos: %u defined, %lu presses held back, %lu fired, %lu replayed, %lu candidate tests\n", combo_bits_count, (unsigned long)combo_bits_stats.held, (unsigned long)combo_bits_stats.fired, (unsigned long)combo_bits_stats.replayed, (unsigned long)combo_bits_stats.candidates);
+}
@@ -0,0 +1,96 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+/**
+ * \brief Combos matched through bitsets of layout positions.
+ *
+ * The keys held towards a combo are a mask of layout positions (see
+ * `layout_positions`), and each position has a mask of the combos it is
+ * part of.  A press ANDs its position's mask into the candidates, so an
+ * event only looks at the combos containing every key held so far, however
+ * many combos there are.
+ *
+ * A press that can start a combo is held back, along with the next ones
+ * while candidates remain.  Once the held keys are exactly a combo that no
+ * other candidate extends, the combo's keycode is registered; otherwise the
+ * exact match, if any, fires after `COMBO_BITS_TERM`.  Any other outcome
+ * replays the held presses through `process_record`, so sm_td and the rest
+ * see them as if they had never been held.  Presses that cannot start a
+ * combo are not delayed.
+ *
+ * A combo only starts after `COMBO_BITS_IDLE_MS` without a key press, so
+ * fast rolls while typing go straight through instead of being held back
+ * or fired as a combo.
+ *
+ * Combos are only matched on the base layer.  Their keys must not be QMK
+ * tap keys (LT, MT), as replayed presses skip QMK's tapping logic.
+ */
+
+#ifndef COMBO_BITS_TERM
+#    define COMBO_BITS_TERM 30 // ms for all the keys of a combo to go down.
+#endif // COMBO_BITS_TERM
+
+#ifndef COMBO_BITS_IDLE_MS
+#    define COMBO_BITS_IDLE_MS 150 // ms without a press before a combo may start.
+#endif // COMBO_BITS_IDLE_MS
+
+#ifndef COMBO_BITS_MAX_KEYS
+#    define COMBO_BITS_MAX_KEYS 4 // Largest combo, and presses held back at once.
+#endif // COMBO_BITS_MAX_KEYS
+
+#ifndef COMBO_BITS_MAX_ACTIVE
+#    define COMBO_BITS_MAX_ACTIVE 4 // Combos held down at the same time.
+#endif // COMBO_BITS_MAX_ACTIVE
+
+#define COMBO_BITS_KEY(position) ((uint64_t)1 << (position))
+
+/** Mask of 2 to 4 layout positions, eg. `COMBO_KEYS(P_E, P_R)`. */
+#define COMBO_KEYS(...)                        COMBO_KEYS_N_(__VA_ARGS__, 4, 3, 2, 1)(__VA_ARGS__)
+#define COMBO_KEYS_N_(_1, _2, _3, _4, n, ...)  COMBO_KEYS_##n
+#define COMBO_KEYS_2(a, b)                     (COMBO_BITS_KEY(a) | COMBO_BITS_KEY(b))
+#define COMBO_KEYS_3(a, b, c)                  (COMBO_KEYS_2(a, b) | COMBO_BITS_KEY(c))
+#define COMBO_KEYS_4(a, b, c, d)               (COMBO_KEYS_3(a, b, c) | COMBO_BITS_KEY(d))
+
+typedef struct {
+    uint64_t keys;
+    uint16_t keycode;
+} combo_bits_t;
+
+/** The combos, defined by the keymap.  At most 64. */
+extern const combo_bits_t PROGMEM combo_bits[];
+extern const uint8_t              combo_bits_count;
+
+typedef struct {
+    uint32_t held;       // Presses held back as a possible combo.
+    uint32_t fired;      // Combos registered.
+    uint32_t replayed;   // Held presses that turned out not to be a combo.
+    uint32_t candidates; // Candidates tested for an exact match.
+} combo_bits_stats_t;
+
+extern combo_bits_stats_t combo_bits_stats;
+
+/** Build the per-key candidate masks.  Call from keyboard_post_init_user. */
+void combo_bits_init(void);
+
+/** Match combos.  Call first thing in process_record_user; returns false for held and combo keys. */
+bool combo_bits_process(keyrecord_t *record);
+
+/** Print the counters to the console. */
+void combo_bits_report(void);
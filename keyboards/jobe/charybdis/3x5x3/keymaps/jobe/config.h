@@ -27,15 +27,52 @@
 #endif // __arm__
 
 /* Charybdis-specific features. */
-#define MAX_DEFERRED_EXECUTORS 10
+#define MAX_DEFERRED_EXECUTORS 14
+
+// Keypress and RGB frame code runs from RAM (users/jobe/hot_path.h).  Uncomment
+// to leave it in flash and compare the worst event latency printed by RGB_BNCH.
+// #define HOT_PATH_DISABLE
+
+// Combos on the base layer, listed in `combo_bits` in keymap.c (combo_bits.h).
+#define COMBO_BITS_ENABLE
+
+// GAME_TG on the media layer drops tap-hold from the base layer (see readme.md).
+#define GAMING_PROFILE_ENABLE
 
 #define CHARYBDIS_DRAGSCROLL_REVERSE_Y
 
 #ifdef POINTING_DEVICE_ENABLE
-// Automatically enable the pointer layer when moving the trackball.  See also:
-// - `CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_TIMEOUT_MS`
-// - `CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_THRESHOLD`
+// Automatically enable the pointer layer when moving the trackball.  See also
+// users/jobe/auto_pointer.h:
+// - `AUTO_POINTER_ENTER_THRESHOLD` / `AUTO_POINTER_EXIT_THRESHOLD`
+// - `AUTO_POINTER_RATE_CAP`
+// - `AUTO_POINTER_DECAY_SHIFT`
+// - `AUTO_POINTER_TIMEOUT_MS`
 // #define CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
+
+// Velocity-based pointer acceleration, curve picked per layer in keymap.c.
+// See users/jobe/pointer_accel.h.
+#define POINTER_ACCEL_ENABLE
+
+// Smooth drag-scroll with momentum, replaces the driver's own on DRGSCRL.
+// See users/jobe/drag_scroll.h.
+#define DRAG_SCROLL_ENABLE
+#define DRAG_SCROLL_MOMENTUM
+#define POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#define WHEEL_EXTENDED_REPORT
+
+// Read the sensor every millisecond and send the summed motion once per USB
+// poll, however long the main loop takes.  See users/jobe/pointer_batch.h.
+#define POINTING_DEVICE_TASK_THROTTLE_MS 1
+#define POINTER_BATCH_ENABLE
+
+// Record and replay ball motion through the pipeline with PTR_RPLY, logging
+// each report to the console.  See users/jobe/pointer_replay.h.
+// #define POINTER_REPLAY_ENABLE
+
+// Hold PTR_FLCK and flick the ball for back/forward and workspace switching.
+// See users/jobe/flick_gesture.h.
+#define FLICK_GESTURE_ENABLE
 #endif // POINTING_DEVICE_ENABLE
 
 // Add this line for RGB layer indication
@@ -64,6 +101,35 @@
     // Define the split keyboard LED configuration
     #define RGB_MATRIX_LED_COUNT 36
     #define RGB_MATRIX_SPLIT { 18, 18 }  // 18 LEDs on the left, 18 LEDs on the right
+
+    // Layer indicators light only the keys bound on the layer; mods, arrows
+    // and F-keys get their own colour (layer_indicator.h)
+    #define LAYER_INDICATOR_KEY_CLASSES
+
+    // Typing heatmap (typing_heatmap.h); PERSIST also keeps per-key press
+    // counts in EEPROM for the TYPING_USAGE effect
+    // #define TYPING_HEATMAP_PERSIST
+    #ifdef TYPING_HEATMAP_PERSIST
+        #define EECONFIG_USER_DATA_SIZE (2 * RGB_MATRIX_LED_COUNT)
+    #endif
+
+    // Fixed-point colour kernels (rgb_kernels.h)
+    // #define RGB_KERNEL_GAMMA_ENABLE // Gamma-correct palette colours
+    // #define RGB_KERNEL_BENCH_ENABLE // Cycles-per-frame stats, printed with RGB_BNCH
+    #define RGB_KERNEL_CURRENT_LIMIT_MA 200 // LED current budget per half
+
+    // Lower the frame rate while typing or moving the trackball (rgb_scheduler.h)
+    #define RGB_MATRIX_LED_FLUSH_LIMIT rgb_scheduler_flush_limit()
+    #ifndef __ASSEMBLER__
+        #include <stdint.h>
+        uint16_t rgb_scheduler_flush_limit(void);
+    #endif
+    #define SPLIT_ACTIVITY_ENABLE // So the slave half slows down too
+
+    // The master sends the tap/hold latency stats, the heatmap hits and the
+    // indicated layer to the slave (tap_hold_stats.h, typing_heatmap.h,
+    // layer_indicator.h)
+    #define SPLIT_TRANSACTION_IDS_USER RPC_ID_USER_TAP_HOLD_STATS, RPC_ID_USER_TYPING_HEATMAP, RPC_ID_USER_LAYER_INDICATOR
 #endif
 
 // SM Tap Dance configuration
@@ -42,11 +42,33 @@ enum custom_keycodes {
     HRM_L,  // ALT
     HRM_QUOT, // GUI
     SMTD_KEYCODES_END,   // End of SM Tap Dance keycodes
+    RGB_BNCH, // Print the RGB frame and scan rates (and reset the benchmark)
+    PTR_RPLY, // Hold to record ball motion, tap to replay it (POINTER_REPLAY_ENABLE)
+    PTR_FLCK, // Hold to turn ball flicks into keys (FLICK_GESTURE_ENABLE)
+    GAME_TG,  // Toggle the gaming profile (GAMING_PROFILE_ENABLE)
 };
 
+#include "hot_path.h"
+#define SMTD_HOT_PATH HOT_PATH // Keypress handling stays in RAM on the RP2040
+
 // Include sm_td.h AFTER the enum with SMTD_KEYCODES_BEGIN and SMTD_KEYCODES_END
 #include "sm_td.h"
 #include "rgb_effects.h" // Include the RGB effects
+#include "timing.h"
+#include "layer_dispatch.h"
+#include "profiler.h"
+#ifdef ASYM_DEBOUNCE_ENABLE
+#    include "asym_debounce.h"
+#endif // ASYM_DEBOUNCE_ENABLE
+#ifdef KEYMAP_CACHE_ENABLE
+#    include "keymap_cache.h"
+#endif // KEYMAP_CACHE_ENABLE
+#ifdef COMBO_BITS_ENABLE
+#    include "combo_bits.h"
+#endif // COMBO_BITS_ENABLE
+#ifdef BOOT_TRACE_ENABLE
+#    include "boot_trace.h"
+#endif // BOOT_TRACE_ENABLE
 
 // Define the global flag used by rgb_effects.h
 bool homerow_mod_active = false;
@@ -54,12 +76,299 @@ bool homerow_mod_active = false;
 bool layer_tap_active = false;
 
 #ifdef CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
-#    include "timer.h"
+#    include "auto_pointer.h"
 #endif // CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
+#ifdef POINTER_ACCEL_ENABLE
+#    include "pointer_accel.h"
+#endif // POINTER_ACCEL_ENABLE
+#ifdef DRAG_SCROLL_ENABLE
+#    include "drag_scroll.h"
+#endif // DRAG_SCROLL_ENABLE
+#ifdef POINTER_BATCH_ENABLE
+#    include "pointer_batch.h"
+#endif // POINTER_BATCH_ENABLE
+#ifdef POINTER_REPLAY_ENABLE
+#    include "pointer_replay.h"
+#endif // POINTER_REPLAY_ENABLE
+#ifdef FLICK_GESTURE_ENABLE
+#    include "flick_gesture.h"
+#endif // FLICK_GESTURE_ENABLE
+
+#ifdef GAMING_PROFILE_ENABLE
+#    ifndef KEYMAP_CACHE_ENABLE
+#        error "GAMING_PROFILE_ENABLE swaps keys in the keymap cache, set KEYMAP_CACHE_ENABLE = yes"
+#    endif // KEYMAP_CACHE_ENABLE
+
+/** \brief Settings kept in the user EEPROM word. */
+typedef union {
+    uint32_t raw;
+    struct {
+        bool gaming : 1;
+    };
+} user_config_t;
+
+static user_config_t user_config;
+
+#    ifdef RGB_MATRIX_ENABLE
+static uint8_t gaming_saved_mode;
+static hsv_t   gaming_saved_hsv;
+
+// A solid colour shows the profile and leaves the main loop to the keys
+static void gaming_profile_rgb(bool enabled) {
+    if (enabled) {
+        gaming_saved_mode = get_base_rgb_matrix_mode();
+        gaming_saved_hsv  = get_base_rgb_matrix_hsv();
+        set_base_rgb_matrix_mode(RGB_MATRIX_SOLID_COLOR, (hsv_t){HSV_TOKYO_ORANGE});
+    } else {
+        set_base_rgb_matrix_mode(gaming_saved_mode, gaming_saved_hsv);
+    }
+}
+#    endif // RGB_MATRIX_ENABLE
+
+// The base layer without tap-hold: home row mods and layer-taps become their
+// tap keycode, except ESC_MED which leads to GAME_TG.
+uint16_t keymap_cache_translate_user(uint8_t layer, keypos_t key, uint16_t keycode) {
+    if (!user_config.gaming || layer != LAYER_BASE) {
+        return keycode;
+    }
+    switch (keycode) {
+        case HRM_A:
+            return KC_A;
+        case HRM_S:
+            return KC_S;
+        case HRM_D:
+            return KC_D;
+        case HRM_F:
+            return KC_F;
+        case HRM_J:
+            return KC_J;
+        case HRM_K:
+            return KC_K;
+        case HRM_L:
+            return KC_L;
+        case HRM_QUOT:
+            return KC_QUOT;
+        case LT(LAYER_MEDIA, KC_ESC): // ESC_MED
+            return keycode;
+    }
+    if (IS_QK_LAYER_TAP(keycode)) {
+        return QK_LAYER_TAP_GET_TAP_KEYCODE(keycode);
+    }
+    return keycode;
+}
+
+static void gaming_profile_toggle(void) {
+    user_config.gaming = !user_config.gaming;
+    eeconfig_update_user(user_config.raw);
+    keymap_cache_load();
+#    ifdef RGB_MATRIX_ENABLE
+    gaming_profile_rgb(user_config.gaming);
+#    endif // RGB_MATRIX_ENABLE
+    // RGB_BNCH then shows the worst event latency of this profile alone
+    hot_path_stats = (hot_path_stats_t){0};
+}
+#endif // GAMING_PROFILE_ENABLE
+
+void keyboard_pre_init_user(void) {
+    // Start the cycle counter before anything wants to be measured.
+    timing_init();
+#ifdef BOOT_TRACE_ENABLE
+    boot_trace_mark(BOOT_PHASE_PRE_INIT);
+#endif // BOOT_TRACE_ENABLE
+}
+
+#if defined(BOOT_TRACE_ENABLE) && defined(RGB_MATRIX_ENABLE)
+static bool rgb_start_deferred = false;
+#endif // BOOT_TRACE_ENABLE && RGB_MATRIX_ENABLE
+
+// Init the first key press can do without
+static void keyboard_post_init_deferred(void) {
+#ifdef KEYMAP_CACHE_ENABLE
+    keymap_cache_load();
+#endif // KEYMAP_CACHE_ENABLE
+#ifdef RGB_MATRIX_ENABLE
+#    ifdef TYPING_HEATMAP_PERSIST
+    typing_heatmap_init();
+#    endif // TYPING_HEATMAP_PERSIST
+#    ifdef BOOT_TRACE_ENABLE
+    if (rgb_start_deferred) {
+        rgb_matrix_enable_noeeprom();
+    }
+#    endif // BOOT_TRACE_ENABLE
+#endif // RGB_MATRIX_ENABLE
+}
+
+void keyboard_post_init_user(void) {
+#ifdef BOOT_TRACE_ENABLE
+    boot_trace_mark(BOOT_PHASE_POST_INIT);
+#endif // BOOT_TRACE_ENABLE
+#ifdef GAMING_PROFILE_ENABLE
+    // Before the keymap is cached, as the profile changes it
+    user_config.raw = eeconfig_read_user();
+#endif // GAMING_PROFILE_ENABLE
+#ifdef COMBO_BITS_ENABLE
+    combo_bits_init();
+#endif // COMBO_BITS_ENABLE
+#ifdef RGB_MATRIX_ENABLE
+#    if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+    tap_hold_stats_init();
+    typing_heatmap_split_init();
+    layer_indicator_split_init();
+#    endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
+#    ifdef GAMING_PROFILE_ENABLE
+    if (user_config.gaming) {
+        gaming_profile_rgb(true);
+    }
+#    endif // GAMING_PROFILE_ENABLE
+#endif // RGB_MATRIX_ENABLE
+
+#ifdef BOOT_TRACE_ENABLE
+#    ifdef RGB_MATRIX_ENABLE
+    // The first effect frames wait with the rest
+    rgb_start_deferred = rgb_matrix_is_enabled();
+    if (rgb_start_deferred) {
+        rgb_matrix_disable_noeeprom();
+    }
+#    endif // RGB_MATRIX_ENABLE
+    boot_trace_defer(keyboard_post_init_deferred);
+#else
+    keyboard_post_init_deferred();
+#endif // BOOT_TRACE_ENABLE
+}
+
+void housekeeping_task_user(void) {
+    PROFILE_BEGIN(PROFILE_HOUSEKEEPING);
+#ifdef BOOT_TRACE_ENABLE
+    boot_trace_task();
+#endif // BOOT_TRACE_ENABLE
+#ifdef RGB_MATRIX_ENABLE
+    rgb_scheduler_task();
+#    if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+    tap_hold_stats_sync();
+    typing_heatmap_sync();
+    layer_indicator_sync();
+#    endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
+#endif // RGB_MATRIX_ENABLE
+    PROFILE_END(PROFILE_HOUSEKEEPING);
+}
+
+#ifdef BOOT_TRACE_ENABLE
+static bool suspended = false;
+
+void suspend_power_down_user(void) {
+    // Called on every pass of the suspend loop, only the first one is stamped
+    if (!suspended) {
+        suspended = true;
+        boot_trace_mark(BOOT_PHASE_SUSPEND);
+    }
+}
+
+void suspend_wakeup_init_user(void) {
+    suspended = false;
+    boot_trace_mark(BOOT_PHASE_WAKEUP);
+}
+#endif // BOOT_TRACE_ENABLE
+
+#ifdef RGB_MATRIX_ENABLE
+_Static_assert(SMTD_KEYCODES_END - SMTD_KEYCODES_BEGIN - 1 <= TAP_HOLD_STATS_KEYS, "TAP_HOLD_STATS_KEYS too small for the SMTD keys");
+
+bool rgb_matrix_indicators_user(void) {
+    rgb_scheduler_frame();
+    return true;
+}
+#endif // RGB_MATRIX_ENABLE
+
+static HOT_PATH bool process_record_keymap(uint16_t keycode, keyrecord_t *record) {
+#ifdef GAMING_PROFILE_ENABLE
+    // Plain keycodes skip combos, sm_td and the RGB bookkeeping in one branch
+    if (user_config.gaming && keycode < SAFE_RANGE) {
+        return true;
+    }
+#endif // GAMING_PROFILE_ENABLE
+
+#ifdef COMBO_BITS_ENABLE
+    // Held back presses come back through here once they turn out not to be a combo
+    if (!combo_bits_process(record)) {
+        return false;
+    }
+#endif // COMBO_BITS_ENABLE
+
+#ifdef DRAG_SCROLL_ENABLE
+    if (keycode == DRGSCRL) {
+        // Momentary, the driver's own drag-scroll never engages
+        drag_scroll_set_enabled(record->event.pressed);
+        return false;
+    }
+#endif // DRAG_SCROLL_ENABLE
+
+#ifdef POINTER_REPLAY_ENABLE
+    if (keycode == PTR_RPLY) {
+        pointer_replay_key(record);
+        return false;
+    }
+#endif // POINTER_REPLAY_ENABLE
+
+#ifdef FLICK_GESTURE_ENABLE
+    if (keycode == PTR_FLCK) {
+        flick_gesture_set_armed(record->event.pressed);
+        return false;
+    }
+#endif // FLICK_GESTURE_ENABLE
+
+#ifdef GAMING_PROFILE_ENABLE
+    if (keycode == GAME_TG) {
+        if (record->event.pressed) {
+            gaming_profile_toggle();
+        }
+        return false;
+    }
+#endif // GAMING_PROFILE_ENABLE
+
+#ifdef RGB_MATRIX_ENABLE
+    if (keycode == RGB_BNCH) {
+        if (record->event.pressed) {
+#    ifdef RGB_KERNEL_BENCH_ENABLE
+            rgb_kernel_bench_report();
+#    endif // RGB_KERNEL_BENCH_ENABLE
+            rgb_scheduler_report();
+            layer_dispatch_report();
+            hot_path_report();
+#    ifdef ASYM_DEBOUNCE_ENABLE
+            asym_debounce_report();
+#    endif // ASYM_DEBOUNCE_ENABLE
+#    ifdef KEYMAP_CACHE_ENABLE
+            keymap_cache_report();
+#    endif // KEYMAP_CACHE_ENABLE
+#    ifdef COMBO_BITS_ENABLE
+            combo_bits_report();
+#    endif // COMBO_BITS_ENABLE
+#    ifdef BOOT_TRACE_ENABLE
+            boot_trace_report();
+#    endif // BOOT_TRACE_ENABLE
+#    ifdef POINTER_BATCH_ENABLE
+            pointer_batch_report();
+#    endif // POINTER_BATCH_ENABLE
+#    ifdef PROFILER_ENABLE
+            profiler_report();
+#    endif // PROFILER_ENABLE
+        }
+        return false;
+    }
+#endif // RGB_MATRIX_ENABLE
+
+#ifdef RGB_MATRIX_ENABLE
+    // Physical presses, before SMTD gets to hold or replay them
+    typing_heatmap_record(record);
+    if (keycode > SMTD_KEYCODES_BEGIN && keycode < SMTD_KEYCODES_END) {
+        tap_hold_stats_press(keycode - SMTD_KEYCODES_BEGIN - 1, record);
+    }
+#endif // RGB_MATRIX_ENABLE
 
-bool process_record_user(uint16_t keycode, keyrecord_t *record) {
     // Original SMTD processing (keep this active)
-    if (!process_smtd(keycode, record)) {
+    PROFILE_BEGIN(PROFILE_SMTD);
+    bool smtd_continue = process_smtd(keycode, record);
+    PROFILE_END(PROFILE_SMTD);
+    if (!smtd_continue) {
         return false;
     }
     
@@ -90,8 +399,22 @@ bool process_record_user(uint16_t keycode, keyrecord_t *record) {
     return true;
 }
 
+bool process_record_user(uint16_t keycode, keyrecord_t *record) {
+    // Timed from here so the worst case includes any flash cache misses
+    uint32_t start  = timing_read_cycles();
+    bool     result = process_record_keymap(keycode, record);
+    hot_path_measure(start);
+#ifdef PROFILER_ENABLE
+    profiler_record(PROFILE_PROCESS_RECORD, timing_cycles_since(start));
+#endif // PROFILER_ENABLE
+#ifdef BOOT_TRACE_ENABLE
+    boot_trace_key();
+#endif // BOOT_TRACE_ENABLE
+    return result;
+}
+
 // SM Tap Dance action handler
-void on_smtd_action(uint16_t keycode, smtd_action action, uint8_t tap_count) {
+HOT_PATH void on_smtd_action(uint16_t keycode, smtd_action action, uint8_t tap_count) {
     switch (keycode) {
         // Left-hand home row mods
         SMTD_MT(HRM_A, KC_A, KC_LGUI, 1000)  // Regular mod-tap behavior with longer threshold
@@ -110,24 +433,16 @@ void on_smtd_action(uint16_t keycode, smtd_action action, uint8_t tap_count) {
 #ifdef RGB_MATRIX_ENABLE
     // Call the RGB handling function for homerow mods
     update_rgb_for_homerow_mods(keycode, action);
+    // Time from press to the tap or hold decision, for TAP_HOLD_LATENCY
+    if (action == SMTD_ACTION_TAP || action == SMTD_ACTION_HOLD) {
+        tap_hold_stats_decide(keycode - SMTD_KEYCODES_BEGIN - 1, get_smtd_timeout_or_default(keycode, SMTD_TIMEOUT_TAP));
+    }
 #endif
 }
 
 // Automatically enable sniping-mode on the pointer layer.
 #define CHARYBDIS_AUTO_SNIPING_ON_LAYER LAYER_POINTER
 
-#ifdef CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
-static uint16_t auto_pointer_layer_timer = 0;
-
-#    ifndef CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_TIMEOUT_MS
-#        define CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_TIMEOUT_MS 1000
-#    endif // CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_TIMEOUT_MS
-
-#    ifndef CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_THRESHOLD
-#        define CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_THRESHOLD 8
-#    endif // CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_THRESHOLD
-#endif     // CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
-
 #define ESC_MED LT(LAYER_MEDIA, KC_ESC)
 #define SPC_NAV LT(LAYER_NAVIGATION, KC_SPC)
 #define TAB_FUN LT(LAYER_FUNCTION, KC_TAB)
@@ -190,14 +505,14 @@ static uint16_t auto_pointer_layer_timer = 0;
 #define LAYOUT_LAYER_MEDIA                                                                        \
     XXXXXXX,RGB_RMOD, RGB_TOG, RGB_MOD, XXXXXXX,     XXXXXXX,RGB_RMOD, RGB_TOG, RGB_MOD, XXXXXXX, \
     KC_MPRV, KC_VOLD, KC_MUTE, KC_VOLU, KC_MNXT,     KC_MPRV, KC_VOLD, KC_MUTE, KC_VOLU, KC_MNXT, \
-    XXXXXXX, XXXXXXX, XXXXXXX,  EE_CLR, QK_BOOT,     QK_BOOT,  EE_CLR, XXXXXXX, XXXXXXX, XXXXXXX, \
+    RGB_BNCH,GAME_TG, XXXXXXX,  EE_CLR, QK_BOOT,     QK_BOOT,  EE_CLR, XXXXXXX, XXXXXXX, XXXXXXX, \
              KC_MPLY, KC_MSTP, KC_MSTP,      KC_MSTP, KC_MPLY, KC_MPLY
 
 /** \brief Mouse emulation and pointer functions. */
 #define LAYOUT_LAYER_POINTER                                                                      \
     QK_BOOT,  EE_CLR, XXXXXXX, DPI_MOD, S_D_MOD,     S_D_MOD, DPI_MOD, XXXXXXX,  EE_CLR, QK_BOOT, \
     KC_LGUI, KC_LALT, KC_LCTL, KC_LSFT, XXXXXXX,     XXXXXXX, KC_LSFT, KC_LCTL, KC_LALT, KC_LGUI, \
-    XXXXXXX, DRGSCRL, SNIPING, XXXXXXX, XXXXXXX,     XXXXXXX, XXXXXXX, SNIPING, DRGSCRL, XXXXXXX, \
+    XXXXXXX, DRGSCRL, SNIPING, PTR_RPLY,PTR_FLCK,    PTR_FLCK,XXXXXXX, SNIPING, DRGSCRL, XXXXXXX, \
              KC_BTN2, KC_BTN1, KC_BTN3,      KC_BTN3, KC_BTN1, XXXXXXX
 
 /**
@@ -298,44 +613,159 @@ const uint16_t PROGMEM keymaps[][MATRIX_ROWS][MATRIX_COLS] = {
   [LAYER_POINTER] = LAYOUT_wrapper(LAYOUT_LAYER_POINTER),
   [LAYER_SYMBOLS] = LAYOUT_wrapper(LAYOUT_LAYER_SYMBOLS),
 };
+
+/** \brief Layout index (+1) of every matrix position, see utils.h. */
+const uint8_t PROGMEM layout_positions[MATRIX_ROWS][MATRIX_COLS] = LAYOUT_wrapper(
+     1,  2,  3,  4,  5,      6,  7,  8,  9, 10,
+    11, 12, 13, 14, 15,     16, 17, 18, 19, 20,
+    21, 22, 23, 24, 25,     26, 27, 28, 29, 30,
+            31, 32, 33,     34, 35, 36
+);
+
+#ifdef COMBO_BITS_ENABLE
+/** \brief Base layer keys by layout position, for the combos.  Z and / are pointer layer-taps, so they are left out. */
+enum combo_positions {
+    P_Q, P_W, P_E, P_R, P_T,    P_Y, P_U, P_I, P_O, P_P,
+    P_A, P_S, P_D, P_F, P_G,    P_H, P_J, P_K, P_L, P_QUOT,
+    P_Z, P_X, P_C, P_V, P_B,    P_N, P_M, P_COMM, P_DOT, P_SLSH,
+};
+
+// clang-format off
+const combo_bits_t PROGMEM combo_bits[] = {
+    // Never two home row mods together, that is a mod chord; no common bigrams either, they roll within the term
+    // Brackets, on the bottom row: opening on the left, closing mirrored on the right
+    {COMBO_KEYS(P_Z, P_X), KC_LBRC}, {COMBO_KEYS(P_DOT, P_SLSH), KC_RBRC},
+    {COMBO_KEYS(P_X, P_C), KC_LPRN}, {COMBO_KEYS(P_COMM, P_DOT), KC_RPRN},
+    {COMBO_KEYS(P_C, P_V), KC_LCBR}, {COMBO_KEYS(P_M, P_COMM), KC_RCBR},
+    {COMBO_KEYS(P_N, P_M), KC_UNDS},
+    {COMBO_KEYS(P_M, P_COMM, P_DOT), KC_MINS}, {COMBO_KEYS(P_COMM, P_DOT, P_SLSH), KC_EQL},
+    // Symbols, top and home row of a column
+    {COMBO_KEYS(P_Q, P_A), KC_GRV},  {COMBO_KEYS(P_W, P_S), KC_AT},
+    {COMBO_KEYS(P_R, P_F), KC_DLR},  {COMBO_KEYS(P_T, P_G), KC_PERC},
+    {COMBO_KEYS(P_Y, P_H), KC_CIRC}, {COMBO_KEYS(P_U, P_J), KC_AMPR},
+    {COMBO_KEYS(P_I, P_K), KC_ASTR}, {COMBO_KEYS(P_P, P_QUOT), KC_PIPE},
+    // Editing, home and bottom row of a column
+    {COMBO_KEYS(P_S, P_X), C(KC_Z)},  {COMBO_KEYS(P_D, P_C), C(KC_C)},
+    {COMBO_KEYS(P_F, P_V), C(KC_V)},  {COMBO_KEYS(P_G, P_B), C(KC_X)},
+    {COMBO_KEYS(P_Z, P_X, P_C), C(KC_A)}, {COMBO_KEYS(P_X, P_C, P_V), C(S(KC_Z))},
+    {COMBO_KEYS(P_H, P_N), KC_HOME},  {COMBO_KEYS(P_J, P_M), KC_END},
+    {COMBO_KEYS(P_K, P_COMM), KC_PGUP}, {COMBO_KEYS(P_L, P_DOT), KC_PGDN},
+    // Rare pairs
+    {COMBO_KEYS(P_Q, P_W), KC_ESC},  {COMBO_KEYS(P_V, P_B), KC_CAPS},
+    {COMBO_KEYS(P_Y, P_U), C(KC_BSPC)},
+};
+// clang-format on
+const uint8_t combo_bits_count = ARRAY_SIZE(combo_bits);
+_Static_assert(ARRAY_SIZE(combo_bits) <= 64, "combo_bits holds at most 64 combos");
+#endif // COMBO_BITS_ENABLE
+
+#ifdef RGB_MATRIX_ENABLE
+/** \brief Keys worth lighting on each layer, see layer_indicator.h. */
+const layer_key_masks_t PROGMEM layer_key_masks[] = {
+  [LAYER_FUNCTION] = LAYER_KEY_MASKS(LAYOUT_LAYER_FUNCTION),
+  [LAYER_NAVIGATION] = LAYER_KEY_MASKS(LAYOUT_LAYER_NAVIGATION),
+  [LAYER_MEDIA] = LAYER_KEY_MASKS(LAYOUT_LAYER_MEDIA),
+  [LAYER_NUMERAL] = LAYER_KEY_MASKS(LAYOUT_LAYER_NUMERAL),
+  [LAYER_POINTER] = LAYER_KEY_MASKS(LAYOUT_LAYER_POINTER),
+  [LAYER_SYMBOLS] = LAYER_KEY_MASKS(LAYOUT_LAYER_SYMBOLS),
+};
+#endif // RGB_MATRIX_ENABLE
 // clang-format on
 
 #ifdef POINTING_DEVICE_ENABLE
-#    ifdef CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
-report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
-    if (abs(mouse_report.x) > CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_THRESHOLD || abs(mouse_report.y) > CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_THRESHOLD) {
-        if (auto_pointer_layer_timer == 0) {
-            layer_on(LAYER_POINTER);
-#        ifdef RGB_MATRIX_ENABLE
-            rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
-            rgb_matrix_sethsv_noeeprom(HSV_GREEN);
-#        endif // RGB_MATRIX_ENABLE
-        }
-        auto_pointer_layer_timer = timer_read();
+#    ifdef POINTER_ACCEL_ENABLE
+/** \brief Acceleration curve of each layer; sniping already slows the pointer layer down. */
+static const uint8_t PROGMEM pointer_accel_layer_curves[] = {
+    [LAYER_BASE]       = POINTER_ACCEL_DEFAULT,
+    [LAYER_FUNCTION]   = POINTER_ACCEL_DEFAULT,
+    [LAYER_NAVIGATION] = POINTER_ACCEL_DEFAULT,
+    [LAYER_MEDIA]      = POINTER_ACCEL_DEFAULT,
+    [LAYER_POINTER]    = POINTER_ACCEL_LINEAR,
+    [LAYER_NUMERAL]    = POINTER_ACCEL_DEFAULT,
+    [LAYER_SYMBOLS]    = POINTER_ACCEL_DEFAULT,
+};
+#    endif // POINTER_ACCEL_ENABLE
+
+#    ifdef FLICK_GESTURE_ENABLE
+/** \brief Keys sent by a flick while PTR_FLCK is held. */
+static const uint16_t PROGMEM flick_keycodes[FLICK_DIRECTION_COUNT] = {
+    [FLICK_NONE]  = KC_NO,
+    [FLICK_LEFT]  = KC_WBAK,
+    [FLICK_RIGHT] = KC_WFWD,
+    [FLICK_UP]    = C(G(KC_LEFT)), // Previous workspace
+    [FLICK_DOWN]  = C(G(KC_RGHT)), // Next workspace
+};
+#    endif // FLICK_GESTURE_ENABLE
+
+#    if defined(CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE) || defined(POINTER_ACCEL_ENABLE) || defined(DRAG_SCROLL_ENABLE) || defined(POINTER_BATCH_ENABLE) || defined(FLICK_GESTURE_ENABLE)
+HOT_PATH report_mouse_t pointing_device_task_user(report_mouse_t mouse_report) {
+    PROFILE_BEGIN(PROFILE_POINTING);
+#        ifdef POINTER_REPLAY_ENABLE
+    uint32_t replay_start = pointer_replay_input(&mouse_report);
+#        endif // POINTER_REPLAY_ENABLE
+#        ifdef CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
+    // Triggered on raw sensor motion.  The layer indicator follows through layer_state_set_user.
+    auto_pointer_task(&mouse_report, LAYER_POINTER);
+#        endif // CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
+#        ifdef FLICK_GESTURE_ENABLE
+    flick_direction_t flick = flick_gesture_task(&mouse_report);
+    if (flick != FLICK_NONE) {
+        tap_code16(pgm_read_word(&flick_keycodes[flick]));
     }
+#        endif // FLICK_GESTURE_ENABLE
+#        ifdef DRAG_SCROLL_ENABLE
+    // Takes x/y while scrolling, so acceleration only sees pointer motion
+    drag_scroll_task(&mouse_report);
+#        endif // DRAG_SCROLL_ENABLE
+#        ifdef POINTER_ACCEL_ENABLE
+    pointer_accel_task(&mouse_report, pgm_read_byte(&pointer_accel_layer_curves[get_highest_layer(layer_state)]));
+#        endif // POINTER_ACCEL_ENABLE
+#        ifdef POINTER_BATCH_ENABLE
+    // Last, so everything above still works on single sensor reads
+    pointer_batch_task(&mouse_report);
+#        endif // POINTER_BATCH_ENABLE
+#        ifdef POINTER_REPLAY_ENABLE
+    pointer_replay_output(&mouse_report, replay_start);
+#        endif // POINTER_REPLAY_ENABLE
+    PROFILE_END(PROFILE_POINTING);
     return mouse_report;
 }
+#    endif // CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE || POINTER_ACCEL_ENABLE || DRAG_SCROLL_ENABLE || POINTER_BATCH_ENABLE || FLICK_GESTURE_ENABLE
+
+#endif     // POINTING_DEVICE_ENABLE
 
-void matrix_scan_user(void) {
-    if (auto_pointer_layer_timer != 0 && TIMER_DIFF_16(timer_read(), auto_pointer_layer_timer) >= CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_TIMEOUT_MS) {
-        auto_pointer_layer_timer = 0;
-        layer_off(LAYER_POINTER);
-#        ifdef RGB_MATRIX_ENABLE
-        layer_state_set_user(layer_state);
-#        endif // RGB_MATRIX_ENABLE
+static layer_state_t layer_state_set_keymap(layer_state_t state) {
+    // Each side effect only runs when its own input changes, see layer_dispatch.h
+    layer_transition_t transition;
+    if (!layer_dispatch_begin(state, &transition)) {
+        return state;
     }
-}
-#    endif // CHARYBDIS_AUTO_POINTER_LAYER_TRIGGER_ENABLE
 
-#    ifdef CHARYBDIS_AUTO_SNIPING_ON_LAYER
-layer_state_t layer_state_set_user(layer_state_t state) {
+#if defined(POINTING_DEVICE_ENABLE) && defined(CHARYBDIS_AUTO_SNIPING_ON_LAYER)
     // Original auto-sniping logic
-    charybdis_set_pointer_sniping_enabled(layer_state_cmp(state, CHARYBDIS_AUTO_SNIPING_ON_LAYER));
+    static uint8_t sniping = LAYER_DISPATCH_UNSET;
+    if (layer_dispatch_changed(&sniping, layer_state_cmp(state, CHARYBDIS_AUTO_SNIPING_ON_LAYER))) {
+        charybdis_set_pointer_sniping_enabled(sniping);
+    }
+#endif // POINTING_DEVICE_ENABLE && CHARYBDIS_AUTO_SNIPING_ON_LAYER
+
+#ifdef RGB_MATRIX_ENABLE
+    // Light the keys bound on the new layer
+    static uint8_t rgb_layer = LAYER_DISPATCH_UNSET;
+    if (layer_dispatch_changed(&rgb_layer, transition.highest)) {
+        update_rgb_for_layer(state);
+    }
+#endif // RGB_MATRIX_ENABLE
 
     return state;
 }
-#    endif // CHARYBDIS_AUTO_SNIPING_ON_LAYER
-#endif     // POINTING_DEVICE_ENABLE
+
+layer_state_t layer_state_set_user(layer_state_t state) {
+    PROFILE_BEGIN(PROFILE_LAYER_STATE);
+    state = layer_state_set_keymap(state);
+    PROFILE_END(PROFILE_LAYER_STATE);
+    return state;
+}
 
 #ifdef RGB_MATRIX_ENABLE
 // Forward-declare this helper function since it is defined in
@@ -0,0 +1,139 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "layer_indicator.h"
+#include "hot_path.h"
+#include "utils.h"
+
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+#    include "transactions.h"
+#endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
+
+#ifndef LAYER_INDICATOR_MOD_COLOR
+#    define LAYER_INDICATOR_MOD_COLOR RGB_TOKYO_MAGENTA
+#endif // LAYER_INDICATOR_MOD_COLOR
+
+#ifndef LAYER_INDICATOR_NAV_COLOR
+#    define LAYER_INDICATOR_NAV_COLOR RGB_TOKYO_GREEN
+#endif // LAYER_INDICATOR_NAV_COLOR
+
+#ifndef LAYER_INDICATOR_FKEY_COLOR
+#    define LAYER_INDICATOR_FKEY_COLOR RGB_TOKYO_YELLOW
+#endif // LAYER_INDICATOR_FKEY_COLOR
+
+// LED-order masks for the layer currently shown.
+static layer_key_masks_t layer_indicator_leds;
+static rgb_t             layer_indicator_color;
+static bool              layer_indicator_dirty = true;
+static uint8_t           layer_indicator_level = 0;
+
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+// What gets mirrored to the other half.
+typedef struct {
+    uint8_t layer;
+    rgb_t   color;
+} layer_indicator_shown_t;
+
+static layer_indicator_shown_t layer_indicator_shown;
+static bool                    layer_indicator_unsent = false;
+#endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
+
+static void layer_indicator_apply(uint8_t layer, rgb_t color) {
+    layer_key_masks_t layout;
+    memcpy_P(&layout, &layer_key_masks[layer], sizeof(layout));
+
+    layer_indicator_leds = (layer_key_masks_t){0};
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint8_t position = pgm_read_byte(&layout_positions[row][col]);
+            uint8_t led      = g_led_config.matrix_co[row][col];
+            if (position == 0 || led == NO_LED) {
+                continue;
+            }
+            uint64_t layout_bit = (uint64_t)1 << (position - 1);
+            uint64_t led_bit    = (uint64_t)1 << led;
+            if (layout.bound & layout_bit) {
+                layer_indicator_leds.bound |= led_bit;
+            }
+            if (layout.mods & layout_bit) {
+                layer_indicator_leds.mods |= led_bit;
+            }
+            if (layout.nav & layout_bit) {
+                layer_indicator_leds.nav |= led_bit;
+            }
+            if (layout.fkeys & layout_bit) {
+                layer_indicator_leds.fkeys |= led_bit;
+            }
+        }
+    }
+    layer_indicator_color = color;
+    layer_indicator_dirty = true;
+}
+
+void layer_indicator_set(uint8_t layer, rgb_t color) {
+    layer_indicator_apply(layer, color);
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+    layer_indicator_shown  = (layer_indicator_shown_t){.layer = layer, .color = color};
+    layer_indicator_unsent = true;
+#endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
+}
+
+static HOT_PATH void layer_indicator_paint(uint64_t mask, rgb_t color) {
+    for (; mask; mask &= mask - 1) {
+        rgb_kernel_frame[__builtin_ctzll(mask)] = color;
+    }
+}
+
+HOT_PATH void layer_indicator_render(bool reset) {
+    if (!reset && !layer_indicator_dirty && layer_indicator_level == rgb_matrix_config.hsv.v) {
+        return;
+    }
+
+    rgb_kernel_fill(rgb_kernel_frame, (rgb_t){0, 0, 0}, RGB_MATRIX_LED_COUNT);
+    layer_indicator_paint(layer_indicator_leds.bound, layer_indicator_color);
+#ifdef LAYER_INDICATOR_KEY_CLASSES
+    layer_indicator_paint(layer_indicator_leds.fkeys, RGB_KERNEL_RGB(LAYER_INDICATOR_FKEY_COLOR));
+    layer_indicator_paint(layer_indicator_leds.nav, RGB_KERNEL_RGB(LAYER_INDICATOR_NAV_COLOR));
+    layer_indicator_paint(layer_indicator_leds.mods, RGB_KERNEL_RGB(LAYER_INDICATOR_MOD_COLOR));
+#endif // LAYER_INDICATOR_KEY_CLASSES
+    rgb_kernel_scale_batch(rgb_kernel_frame, RGB_MATRIX_LED_COUNT);
+
+    layer_indicator_dirty = false;
+    layer_indicator_level = rgb_matrix_config.hsv.v;
+}
+
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+static void layer_indicator_receive(uint8_t in_len, const void *in_data, uint8_t out_len, void *out_data) {
+    if (in_len == sizeof(layer_indicator_shown_t)) {
+        const layer_indicator_shown_t *shown = in_data;
+        layer_indicator_apply(shown->layer, shown->color);
+    }
+}
+
+void layer_indicator_split_init(void) {
+    transaction_register_rpc(RPC_ID_USER_LAYER_INDICATOR, layer_indicator_receive);
+}
+
+void layer_indicator_sync(void) {
+    // Only the master runs layer_state_set_user; the slave's masks come from here.
+    if (!is_keyboard_master() || !layer_indicator_unsent) {
+        return;
+    }
+    if (transaction_rpc_send(RPC_ID_USER_LAYER_INDICATOR, sizeof(layer_indicator_shown), &layer_indicator_shown)) {
+        layer_indicator_unsent = false;
+    }
+}
+#endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
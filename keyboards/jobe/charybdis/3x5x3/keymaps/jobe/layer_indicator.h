@@ -0,0 +1,70 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+#include "rgb_kernels.h"
+
+/**
+ * \brief Key classes of a layer, as layout-order bitmasks (see `LAYOUT_KEY_MASK`).
+ *
+ * Only `bound` is required; the other classes get their own colour when
+ * `LAYER_INDICATOR_KEY_CLASSES` is defined.
+ */
+typedef struct {
+    uint64_t bound; // Keys that do anything on the layer.
+    uint64_t mods;  // Modifiers.
+    uint64_t nav;   // Arrows and the navigation cluster.
+    uint64_t fkeys; // F1 to F12.
+} layer_key_masks_t;
+
+#define LAYER_KEY_MASKS(...)                               \
+    {                                                      \
+        .bound = LAYOUT_KEY_MASK(KEY_IS_BOUND, __VA_ARGS__), \
+        .mods  = LAYOUT_KEY_MASK(KEY_IS_MOD, __VA_ARGS__),   \
+        .nav   = LAYOUT_KEY_MASK(KEY_IS_NAV, __VA_ARGS__),   \
+        .fkeys = LAYOUT_KEY_MASK(KEY_IS_FKEY, __VA_ARGS__),  \
+    }
+
+/** Per-layer masks, defined next to the layouts in keymap.c. */
+extern const layer_key_masks_t PROGMEM layer_key_masks[];
+
+/**
+ * \brief Light the bound keys of `layer` in `color`.
+ *
+ * Converts the layout masks to LED masks once, here, so rendering is only a
+ * loop over set bits.  Takes effect through the LAYER_INDICATOR effect.  On
+ * a split board, call it on the master; `layer_indicator_sync` passes the
+ * layer and colour on to the slave, which never sees layer_state_set_user.
+ */
+void layer_indicator_set(uint8_t layer, rgb_t color);
+
+/**
+ * \brief Redraw `rgb_kernel_frame` if the layer or the brightness changed.
+ *
+ * `reset` forces the redraw, eg. when the effect starts after another one
+ * used the frame.
+ */
+void layer_indicator_render(bool reset);
+
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+/** Register the split transaction.  Call from keyboard_post_init_user. */
+void layer_indicator_split_init(void);
+
+/** Send a changed layer or colour to the other half.  Call from housekeeping_task_user. */
+void layer_indicator_sync(void);
+#endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
@@ -18,10 +18,17 @@
 
 #include QMK_KEYBOARD_H
 #include "sm_td.h"
+#include "rgb_kernels.h"
+#include "layer_indicator.h"
+#include "typing_heatmap.h"
+#include "rgb_scheduler.h"
+#include "tap_hold_stats.h"
 
 // Flag to indicate if a homerow modifier is currently active
 // Remove static and declare as extern, definition will be in keymap.c
 extern bool homerow_mod_active;
+// Set while a layer-tap key is held, definition is in keymap.c
+extern bool layer_tap_active;
 
 // Forward declaration of layer state functions
 #ifndef LAYER_STATE_H_
@@ -34,17 +41,6 @@ static uint8_t saved_rgb_matrix_mode = RGB_MATRIX_SOLID_REACTIVE_SIMPLE; // Defa
 static hsv_t saved_rgb_matrix_hsv = {HSV_BLUE}; // Properly initialize with braces
 static bool mode_saved = false;
 
-// Tokyo Night theme HSV color definitions - more deeply saturated and darkened
-#define HSV_TOKYO_TEAL     170, 255, 120  // Deeper teal, less whitish
-#define HSV_TOKYO_BLUE     215, 255, 120  // Deeper blue, more saturated
-#define HSV_TOKYO_PURPLE   280, 255, 120  // Stronger purple
-#define HSV_TOKYO_MAGENTA  330, 255, 130  // Rich magenta
-#define HSV_TOKYO_PINK     350, 255, 130  // Stronger pink
-#define HSV_TOKYO_ORANGE    10, 255, 140  // Deeper orange
-#define HSV_TOKYO_YELLOW    60, 255, 130  // Richer yellow
-#define HSV_TOKYO_GREEN    120, 255, 100  // More vivid green
-#define HSV_TOKYO_SEAFOAM  160, 255, 100  // Deeper seafoam
-
 // Charybdis 3x5x3 LED layout
 // The split keyboard has LEDs arranged in a matrix where:
 // Left side LEDs typically have indices 0 to (RGBLED_NUM/2-1)
@@ -55,6 +51,10 @@ static bool mode_saved = false;
 void save_rgb_matrix_mode(void);
 void restore_rgb_matrix_mode(void);
 void update_rgb_for_layer(layer_state_t state);
+void update_rgb_for_layer_tap(uint16_t keycode, bool pressed);
+void set_base_rgb_matrix_mode(uint8_t mode, hsv_t hsv);
+uint8_t get_base_rgb_matrix_mode(void);
+hsv_t get_base_rgb_matrix_hsv(void);
 
 // Function to save the current RGB matrix mode
 void save_rgb_matrix_mode(void) {
@@ -74,8 +74,37 @@ void restore_rgb_matrix_mode(void) {
     }
 }
 
+// Change the mode the overlays return to, or the current one if none is up
+void set_base_rgb_matrix_mode(uint8_t mode, hsv_t hsv) {
+    if (mode_saved) {
+        saved_rgb_matrix_mode = mode;
+        saved_rgb_matrix_hsv  = hsv;
+    } else {
+        rgb_matrix_mode_noeeprom(mode);
+        rgb_matrix_sethsv_noeeprom(hsv.h, hsv.s, hsv.v);
+    }
+}
+
+// The mode the overlays return to
+uint8_t get_base_rgb_matrix_mode(void) {
+    return mode_saved ? saved_rgb_matrix_mode : rgb_matrix_get_mode();
+}
+
+hsv_t get_base_rgb_matrix_hsv(void) {
+    return mode_saved ? saved_rgb_matrix_hsv : rgb_matrix_get_hsv();
+}
+
+// The latency visualizer has to stay up while the keys it measures are used
+static bool rgb_overlays_paused(void) {
+    return !mode_saved && rgb_matrix_get_mode() == RGB_MATRIX_CUSTOM_TAP_HOLD_LATENCY;
+}
+
 // Function to handle RGB color changes for homerow mods
 void update_rgb_for_homerow_mods(uint16_t keycode, smtd_action action) {
+    if (rgb_overlays_paused()) {
+        return;
+    }
+
     // Change RGB color based on homerow mod activation
     if (action == SMTD_ACTION_HOLD) {
         save_rgb_matrix_mode(); // Save current mode before changing
@@ -130,7 +159,7 @@ void update_rgb_for_homerow_mods(uint16_t keycode, smtd_action action) {
 // Layer RGB color settings function
 void update_rgb_for_layer(layer_state_t state) {
     // Don't update layer color if a homerow mod is active
-    if (homerow_mod_active) {
+    if (homerow_mod_active || rgb_overlays_paused()) {
         return;
     }
     
@@ -144,40 +173,48 @@ void update_rgb_for_layer(layer_state_t state) {
         switch (highest_layer) {
             case LAYER_FUNCTION:
                 // Function layer - Tokyo Blue
-                rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
-                rgb_matrix_sethsv_noeeprom(HSV_TOKYO_BLUE);
+                layer_indicator_set(highest_layer, RGB_KERNEL_RGB(RGB_TOKYO_BLUE));
                 break;
             case LAYER_NAVIGATION:
                 // Navigation layer - Tokyo Teal
-                rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
-                rgb_matrix_sethsv_noeeprom(HSV_TOKYO_TEAL);
+                layer_indicator_set(highest_layer, RGB_KERNEL_RGB(RGB_TOKYO_TEAL));
                 break;
             case LAYER_MEDIA:
                 // Media layer - Tokyo Yellow
-                rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
-                rgb_matrix_sethsv_noeeprom(HSV_TOKYO_YELLOW);
+                layer_indicator_set(highest_layer, RGB_KERNEL_RGB(RGB_TOKYO_YELLOW));
                 break;
             case LAYER_POINTER:
                 // Pointer layer - Tokyo Seafoam
-                rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
-                rgb_matrix_sethsv_noeeprom(HSV_TOKYO_SEAFOAM);
+                layer_indicator_set(highest_layer, RGB_KERNEL_RGB(RGB_TOKYO_SEAFOAM));
                 break;
             case LAYER_NUMERAL:
                 // Numeral layer - Tokyo Orange
-                rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
-                rgb_matrix_sethsv_noeeprom(HSV_TOKYO_ORANGE);
+                layer_indicator_set(highest_layer, RGB_KERNEL_RGB(RGB_TOKYO_ORANGE));
                 break;
             case LAYER_SYMBOLS:
                 // Symbols layer - Tokyo Purple
-                rgb_matrix_mode_noeeprom(RGB_MATRIX_SOLID_COLOR);
-                rgb_matrix_sethsv_noeeprom(HSV_TOKYO_PURPLE);
+                layer_indicator_set(highest_layer, RGB_KERNEL_RGB(RGB_TOKYO_PURPLE));
                 break;
             default:
                 // For any other layers, restore the default mode
                 restore_rgb_matrix_mode();
-                break;
+                return;
         }
+        // Only the keys bound on the layer are lit
+        rgb_matrix_mode_noeeprom(RGB_MATRIX_CUSTOM_LAYER_INDICATOR);
     }
-} 
+}
+
+// Preview the layer of a layer-tap key while it is held, before the
+// tapping term has decided whether it is a tap or a hold
+void update_rgb_for_layer_tap(uint16_t keycode, bool pressed) {
+    layer_tap_active = pressed;
+    if (pressed) {
+        update_rgb_for_layer(layer_state | ((layer_state_t)1 << QK_LAYER_TAP_GET_LAYER(keycode)));
+    } else {
+        update_rgb_for_layer(layer_state);
+    }
+}
+
 #endif // RGB_MATRIX_ENABLE 
 
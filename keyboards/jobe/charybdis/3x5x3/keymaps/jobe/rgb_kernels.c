@@ -0,0 +1,261 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rgb_kernels.h"
+#include "hot_path.h"
+
+#ifdef RGB_KERNEL_BENCH_ENABLE
+#    include "print.h"
+#endif // RGB_KERNEL_BENCH_ENABLE
+
+rgb_t rgb_kernel_frame[RGB_MATRIX_LED_COUNT];
+
+#ifdef RGB_KERNEL_GAMMA_ENABLE
+// round(255 * (i / 255) ^ 2.2)
+static const uint8_t PROGMEM rgb_kernel_gamma[256] = {
+      0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   1,
+      1,   1,   1,   1,   1,   1,   1,   1,   1,   2,   2,   2,   2,   2,   2,   2,
+      3,   3,   3,   3,   3,   4,   4,   4,   4,   5,   5,   5,   5,   6,   6,   6,
+      6,   7,   7,   7,   8,   8,   8,   9,   9,   9,  10,  10,  11,  11,  11,  12,
+     12,  13,  13,  13,  14,  14,  15,  15,  16,  16,  17,  17,  18,  18,  19,  19,
+     20,  20,  21,  22,  22,  23,  23,  24,  25,  25,  26,  26,  27,  28,  28,  29,
+     30,  30,  31,  32,  33,  33,  34,  35,  35,  36,  37,  38,  39,  39,  40,  41,
+     42,  43,  43,  44,  45,  46,  47,  48,  49,  49,  50,  51,  52,  53,  54,  55,
+     56,  57,  58,  59,  60,  61,  62,  63,  64,  65,  66,  67,  68,  69,  70,  71,
+     73,  74,  75,  76,  77,  78,  79,  81,  82,  83,  84,  85,  87,  88,  89,  90,
+     91,  93,  94,  95,  97,  98,  99, 100, 102, 103, 105, 106, 107, 109, 110, 111,
+    113, 114, 116, 117, 119, 120, 121, 123, 124, 126, 127, 129, 130, 132, 133, 135,
+    137, 138, 140, 141, 143, 145, 146, 148, 149, 151, 153, 154, 156, 158, 159, 161,
+    163, 165, 166, 168, 170, 172, 173, 175, 177, 179, 181, 182, 184, 186, 188, 190,
+    192, 194, 196, 197, 199, 201, 203, 205, 207, 209, 211, 213, 215, 217, 219, 221,
+    223, 225, 227, 229, 231, 234, 236, 238, 240, 242, 244, 246, 248, 251, 253, 255,
+};
+#endif // RGB_KERNEL_GAMMA_ENABLE
+
+static uint8_t rgb_kernel_lut[256];
+// Brightness the LUT was built for; 0 is never valid, so the first use builds it.
+static uint8_t rgb_kernel_lut_level = 0;
+
+// x / 255 without a divide, exact for 0 <= x < 65535.
+static inline uint16_t rgb_kernel_div255(uint16_t x) {
+    return (x + 1 + (x >> 8)) >> 8;
+}
+
+HOT_PATH rgb_t rgb_kernel_hsv_to_rgb(hsv_t hsv) {
+    rgb_t rgb;
+    rgb_kernel_hsv_to_rgb_batch(&hsv, &rgb, 1);
+    return rgb;
+}
+
+HOT_PATH void rgb_kernel_hsv_to_rgb_batch(const hsv_t *in, rgb_t *out, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        uint16_t h = in[i].h;
+        uint16_t s = in[i].s;
+        uint16_t v = in[i].v;
+
+        if (s == 0) {
+            out[i] = (rgb_t){.r = v, .g = v, .b = v};
+            continue;
+        }
+
+        uint8_t region    = rgb_kernel_div255(h * 6);
+        uint8_t remainder = (h * 2 - region * 85) * 3;
+        uint8_t p         = (v * (255 - s)) >> 8;
+        uint8_t q         = (v * (255 - ((s * remainder) >> 8))) >> 8;
+        uint8_t t         = (v * (255 - ((s * (255 - remainder)) >> 8))) >> 8;
+
+        switch (region) {
+            case 1:
+                out[i] = (rgb_t){.r = q, .g = v, .b = p};
+                break;
+            case 2:
+                out[i] = (rgb_t){.r = p, .g = v, .b = t};
+                break;
+            case 3:
+                out[i] = (rgb_t){.r = p, .g = q, .b = v};
+                break;
+            case 4:
+                out[i] = (rgb_t){.r = t, .g = p, .b = v};
+                break;
+            case 5:
+                out[i] = (rgb_t){.r = v, .g = p, .b = q};
+                break;
+            default:
+                out[i] = (rgb_t){.r = v, .g = t, .b = p};
+                break;
+        }
+    }
+}
+
+HOT_PATH void rgb_kernel_fill(rgb_t *out, rgb_t color, uint8_t count) {
+    for (uint8_t i = 0; i < count; i++) {
+        out[i] = color;
+    }
+}
+
+HOT_PATH void rgb_kernel_blend_batch(rgb_t *dst, const rgb_t *src, uint8_t alpha, uint8_t count) {
+    // Stretch 0..255 to 0..256 so both ends are exact after the shift.
+    uint16_t a  = alpha + (alpha >> 7);
+    uint16_t na = 256 - a;
+    for (uint8_t i = 0; i < count; i++) {
+        dst[i].r = (src[i].r * a + dst[i].r * na) >> 8;
+        dst[i].g = (src[i].g * a + dst[i].g * na) >> 8;
+        dst[i].b = (src[i].b * a + dst[i].b * na) >> 8;
+    }
+}
+
+static void rgb_kernel_build_lut(uint8_t level) {
+    // Q8 gain; the only divide happens here, once per brightness change.
+    uint32_t gain = ((uint32_t)level << 8) / RGB_MATRIX_MAXIMUM_BRIGHTNESS;
+#ifdef RGB_KERNEL_CURRENT_LIMIT_MA
+    // The current limiter keeps floods in check, so sparse frames may go brighter.
+    gain = (gain * RGB_KERNEL_PEAK_GAIN) >> 8;
+#endif // RGB_KERNEL_CURRENT_LIMIT_MA
+    for (uint16_t x = 0; x < 256; x++) {
+#ifdef RGB_KERNEL_GAMMA_ENABLE
+        uint32_t value = pgm_read_byte(&rgb_kernel_gamma[x]);
+#else
+        uint32_t value = x;
+#endif // RGB_KERNEL_GAMMA_ENABLE
+        value = (value * gain + 128) >> 8;
+        rgb_kernel_lut[x] = value > 255 ? 255 : value;
+    }
+    rgb_kernel_lut_level = level;
+}
+
+HOT_PATH void rgb_kernel_scale_batch(rgb_t *buf, uint8_t count) {
+    uint8_t level = rgb_matrix_config.hsv.v;
+    if (level == 0) {
+        rgb_kernel_fill(buf, (rgb_t){0, 0, 0}, count);
+        return;
+    }
+    if (level != rgb_kernel_lut_level) {
+        rgb_kernel_build_lut(level);
+    }
+    for (uint8_t i = 0; i < count; i++) {
+        buf[i].r = rgb_kernel_lut[buf[i].r];
+        buf[i].g = rgb_kernel_lut[buf[i].g];
+        buf[i].b = rgb_kernel_lut[buf[i].b];
+    }
+}
+
+#ifdef RGB_KERNEL_CURRENT_LIMIT_MA
+#    ifdef RGB_MATRIX_SPLIT
+static const uint8_t rgb_kernel_half_leds[] = RGB_MATRIX_SPLIT;
+#    else
+static const uint8_t rgb_kernel_half_leds[] = {RGB_MATRIX_LED_COUNT};
+#    endif // RGB_MATRIX_SPLIT
+#    define RGB_KERNEL_HALVES (sizeof(rgb_kernel_half_leds) / sizeof(rgb_kernel_half_leds[0]))
+
+// Q8 gain per half, 256 when the frame is within budget.
+static uint16_t rgb_kernel_limit_gain[RGB_KERNEL_HALVES] = {[0 ... RGB_KERNEL_HALVES - 1] = 256};
+
+HOT_PATH void rgb_kernel_limit_current(void) {
+    uint8_t first = 0;
+    for (uint8_t half = 0; half < RGB_KERNEL_HALVES; half++) {
+        uint8_t last = first + rgb_kernel_half_leds[half];
+
+        // Sum of all channel levels; one level draws RGB_KERNEL_CHANNEL_MA / 255.
+        uint32_t levels = 0;
+        for (uint8_t i = first; i < last; i++) {
+            levels += rgb_kernel_frame[i].r + rgb_kernel_frame[i].g + rgb_kernel_frame[i].b;
+        }
+        // What is left of the budget once the LEDs' idle draw is paid for.
+        int32_t budget = ((int32_t)RGB_KERNEL_CURRENT_LIMIT_MA - (int32_t)rgb_kernel_half_leds[half] * RGB_KERNEL_IDLE_MA) * 255 / RGB_KERNEL_CHANNEL_MA;
+        if (budget < 0) {
+            budget = 0;
+        }
+
+        rgb_kernel_limit_gain[half] = levels > (uint32_t)budget ? ((uint32_t)budget << 8) / levels : 256;
+#    ifdef RGB_KERNEL_BENCH_ENABLE
+        if (rgb_kernel_limit_gain[half] < 256) {
+            rgb_kernel_bench.limited++;
+        }
+#    endif // RGB_KERNEL_BENCH_ENABLE
+        first = last;
+    }
+}
+#endif // RGB_KERNEL_CURRENT_LIMIT_MA
+
+HOT_PATH void rgb_kernel_flush(effect_params_t *params, uint8_t led_min, uint8_t led_max) {
+#ifdef RGB_KERNEL_CURRENT_LIMIT_MA
+    // Split limits never let a chunk straddle the two halves.
+    uint16_t gain = rgb_kernel_limit_gain[RGB_KERNEL_HALVES > 1 && led_min >= rgb_kernel_half_leds[0]];
+#endif // RGB_KERNEL_CURRENT_LIMIT_MA
+    for (uint8_t i = led_min; i < led_max; i++) {
+        RGB_MATRIX_TEST_LED_FLAGS();
+        rgb_t color = rgb_kernel_frame[i];
+#ifdef RGB_KERNEL_CURRENT_LIMIT_MA
+        if (gain < 256) {
+            color.r = (color.r * gain) >> 8;
+            color.g = (color.g * gain) >> 8;
+            color.b = (color.b * gain) >> 8;
+        }
+#endif // RGB_KERNEL_CURRENT_LIMIT_MA
+        rgb_matrix_set_color(i, color.r, color.g, color.b);
+#ifdef RGB_KERNEL_BENCH_ENABLE
+        rgb_kernel_bench_hash(i, color);
+#endif // RGB_KERNEL_BENCH_ENABLE
+    }
+}
+
+#ifdef RGB_KERNEL_BENCH_ENABLE
+rgb_kernel_bench_t rgb_kernel_bench;
+
+void rgb_kernel_bench_record(uint32_t cycles, uint8_t led_max) {
+    rgb_kernel_bench.pending += cycles;
+    // The end of this half's LEDs: with RGB_MATRIX_SPLIT the left half stops short of the LED count
+    if (rgb_matrix_check_finished_leds(led_max)) {
+        return;
+    }
+    rgb_kernel_bench.last = rgb_kernel_bench.pending;
+    if (rgb_kernel_bench.last > rgb_kernel_bench.max) {
+        rgb_kernel_bench.max = rgb_kernel_bench.last;
+    }
+    if (rgb_kernel_bench.last > RGB_KERNEL_FRAME_BUDGET_CYCLES) {
+        rgb_kernel_bench.overruns++;
+    }
+    // A frame that matches the previous one could have been skipped.
+    if (rgb_kernel_bench.frames > 0 && rgb_kernel_bench.pending_hash == rgb_kernel_bench.last_hash) {
+        rgb_kernel_bench.redundant++;
+    }
+    rgb_kernel_bench.last_hash = rgb_kernel_bench.pending_hash;
+    rgb_kernel_bench.total += rgb_kernel_bench.last;
+    rgb_kernel_bench.frames++;
+    rgb_kernel_bench.pending      = 0;
+    rgb_kernel_bench.pending_hash = 0;
+}
+
+void rgb_kernel_bench_hash(uint8_t index, rgb_t color) {
+    // FNV-1a style mix; a collision only under-reports redundant frames.
+    uint32_t hash = rgb_kernel_bench.pending_hash;
+    hash          = (hash ^ index) * 0x01000193;
+    hash          = (hash ^ color.r) * 0x01000193;
+    hash          = (hash ^ color.g) * 0x01000193;
+    hash          = (hash ^ color.b) * 0x01000193;
+    rgb_kernel_bench.pending_hash = hash;
+}
+
+void rgb_kernel_bench_report(void) {
+    uint32_t mean = rgb_kernel_bench.frames ? rgb_kernel_bench.total / rgb_kernel_bench.frames : 0;
+    uprintf("rgb: %u frames, cycles/frame last %lu mean %lu max %lu\n", rgb_kernel_bench.frames, (unsigned long)rgb_kernel_bench.last, (unsigned long)mean, (unsigned long)rgb_kernel_bench.max);
+    uprintf("rgb: %u over budget (%lu cycles), %u redundant flushes\n", rgb_kernel_bench.overruns, (unsigned long)RGB_KERNEL_FRAME_BUDGET_CYCLES, rgb_kernel_bench.redundant);
+#    ifdef RGB_KERNEL_CURRENT_LIMIT_MA
+    uprintf("rgb: %u half-frames limited to %u mA\n", rgb_kernel_bench.limited, RGB_KERNEL_CURRENT_LIMIT_MA);
+#    endif // RGB_KERNEL_CURRENT_LIMIT_MA
+    rgb_kernel_bench = (rgb_kernel_bench_t){0};
+}
+#endif // RGB_KERNEL_BENCH_ENABLE
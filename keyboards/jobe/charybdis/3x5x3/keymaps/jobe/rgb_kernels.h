@@ -0,0 +1,201 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+#include "timing.h"
+
+/**
+ * \brief Fixed-point colour kernels for the custom RGB effects.
+ *
+ * Everything here is integer math without division so it stays cheap on the
+ * RP2040's Cortex-M0+.  Effects render into `rgb_kernel_frame`, then hand the
+ * whole buffer to `rgb_kernel_flush` in a single pass.
+ */
+
+// Tokyo Night theme HSV color definitions - more deeply saturated and darkened
+#define HSV_TOKYO_TEAL     170, 255, 120  // Deeper teal, less whitish
+#define HSV_TOKYO_BLUE     215, 255, 120  // Deeper blue, more saturated
+#define HSV_TOKYO_PURPLE   280, 255, 120  // Stronger purple
+#define HSV_TOKYO_MAGENTA  330, 255, 130  // Rich magenta
+#define HSV_TOKYO_PINK     350, 255, 130  // Stronger pink
+#define HSV_TOKYO_ORANGE    10, 255, 140  // Deeper orange
+#define HSV_TOKYO_YELLOW    60, 255, 130  // Richer yellow
+#define HSV_TOKYO_GREEN    120, 255, 100  // More vivid green
+#define HSV_TOKYO_SEAFOAM  160, 255, 100  // Deeper seafoam
+
+/**
+ * \brief Compile-time HSV to RGB.
+ *
+ * Bit-exact with QMK's `hsv_to_rgb()`, including the 8-bit wrap of hues
+ * above 255, so a palette entry looks the same whichever path draws it.
+ * Expands to `r, g, b` like the stock `RGB_*` macros.
+ */
+// clang-format off
+#define RGB_KERNEL_H_(h)         ((h) & 0xFF)
+#define RGB_KERNEL_REGION_(h)    (RGB_KERNEL_H_(h) * 6 / 255)
+#define RGB_KERNEL_REM_(h)       (((RGB_KERNEL_H_(h) * 2 - RGB_KERNEL_REGION_(h) * 85) * 3) & 0xFF)
+#define RGB_KERNEL_P_(h, s, v)   (((v) * (255 - (s))) >> 8)
+#define RGB_KERNEL_Q_(h, s, v)   (((v) * (255 - (((s) * RGB_KERNEL_REM_(h)) >> 8))) >> 8)
+#define RGB_KERNEL_T_(h, s, v)   (((v) * (255 - (((s) * (255 - RGB_KERNEL_REM_(h))) >> 8))) >> 8)
+#define RGB_KERNEL_PICK_(h, s, v, r0, r1, r2, r3, r4, r5)                                    \
+    ((s) == 0 ? (v) :                                                                        \
+     RGB_KERNEL_REGION_(h) == 1 ? RGB_KERNEL_##r1##_(h, s, v) :                              \
+     RGB_KERNEL_REGION_(h) == 2 ? RGB_KERNEL_##r2##_(h, s, v) :                              \
+     RGB_KERNEL_REGION_(h) == 3 ? RGB_KERNEL_##r3##_(h, s, v) :                              \
+     RGB_KERNEL_REGION_(h) == 4 ? RGB_KERNEL_##r4##_(h, s, v) :                              \
+     RGB_KERNEL_REGION_(h) == 5 ? RGB_KERNEL_##r5##_(h, s, v) : RGB_KERNEL_##r0##_(h, s, v))
+#define RGB_KERNEL_V_(h, s, v)   (v)
+#define RGB_KERNEL_FROM_HSV_(h, s, v)                 \
+    RGB_KERNEL_PICK_(h, s, v, V, Q, P, P, T, V),      \
+    RGB_KERNEL_PICK_(h, s, v, T, V, V, Q, P, P),      \
+    RGB_KERNEL_PICK_(h, s, v, P, P, T, V, V, Q)
+#define RGB_KERNEL_FROM_HSV(...) RGB_KERNEL_FROM_HSV_(__VA_ARGS__)
+// clang-format on
+
+/** Tokyo Night palette, resolved to RGB at compile time. */
+#define RGB_TOKYO_TEAL    RGB_KERNEL_FROM_HSV(HSV_TOKYO_TEAL)
+#define RGB_TOKYO_BLUE    RGB_KERNEL_FROM_HSV(HSV_TOKYO_BLUE)
+#define RGB_TOKYO_PURPLE  RGB_KERNEL_FROM_HSV(HSV_TOKYO_PURPLE)
+#define RGB_TOKYO_MAGENTA RGB_KERNEL_FROM_HSV(HSV_TOKYO_MAGENTA)
+#define RGB_TOKYO_PINK    RGB_KERNEL_FROM_HSV(HSV_TOKYO_PINK)
+#define RGB_TOKYO_ORANGE  RGB_KERNEL_FROM_HSV(HSV_TOKYO_ORANGE)
+#define RGB_TOKYO_YELLOW  RGB_KERNEL_FROM_HSV(HSV_TOKYO_YELLOW)
+#define RGB_TOKYO_GREEN   RGB_KERNEL_FROM_HSV(HSV_TOKYO_GREEN)
+#define RGB_TOKYO_SEAFOAM RGB_KERNEL_FROM_HSV(HSV_TOKYO_SEAFOAM)
+
+/** Build an `rgb_t` initializer from an `r, g, b` macro such as `RGB_TOKYO_TEAL`. */
+#define RGB_KERNEL_RGB(...) RGB_KERNEL_RGB_(__VA_ARGS__)
+#define RGB_KERNEL_RGB_(red, green, blue) ((rgb_t){.r = (red), .g = (green), .b = (blue)})
+
+/** Frame buffer shared by the custom effects, one entry per LED. */
+extern rgb_t rgb_kernel_frame[RGB_MATRIX_LED_COUNT];
+
+/** Single HSV to RGB conversion, bit-exact with `hsv_to_rgb()`. */
+rgb_t rgb_kernel_hsv_to_rgb(hsv_t hsv);
+
+/** Convert `count` HSV values in one pass. */
+void rgb_kernel_hsv_to_rgb_batch(const hsv_t *in, rgb_t *out, uint8_t count);
+
+/** Fill `count` LEDs of `out` with a single colour. */
+void rgb_kernel_fill(rgb_t *out, rgb_t color, uint8_t count);
+
+/** Blend `src` over `dst` in place; `alpha` 0 keeps `dst`, 255 takes `src`. */
+void rgb_kernel_blend_batch(rgb_t *dst, const rgb_t *src, uint8_t alpha, uint8_t count);
+
+/**
+ * \brief Scale `count` LEDs through the brightness LUT.
+ *
+ * The LUT maps each channel through the optional gamma curve and the global
+ * brightness (`rgb_matrix_config.hsv.v` relative to
+ * `RGB_MATRIX_MAXIMUM_BRIGHTNESS`).  It has 256 entries and is only rebuilt
+ * when the brightness changes, so scaling costs one table read per channel.
+ * Use it for fixed palette colours, which otherwise ignore the brightness
+ * keys; colours derived from `rgb_matrix_config.hsv` are already scaled.
+ */
+void rgb_kernel_scale_batch(rgb_t *buf, uint8_t count);
+
+/**
+ * \brief Current limiter, enabled by defining `RGB_KERNEL_CURRENT_LIMIT_MA`.
+ *
+ * Estimates each half's LED current from `rgb_kernel_frame` and picks the
+ * gain that keeps it under `RGB_KERNEL_CURRENT_LIMIT_MA`; `rgb_kernel_flush`
+ * applies it.  Call once per frame, after the whole frame is rendered.
+ * A few lit keys are left alone, so kernel effects may then use up to
+ * `RGB_KERNEL_PEAK_GAIN` above `RGB_MATRIX_MAXIMUM_BRIGHTNESS`.
+ */
+#ifdef RGB_KERNEL_CURRENT_LIMIT_MA
+#    ifndef RGB_KERNEL_CHANNEL_MA
+#        define RGB_KERNEL_CHANNEL_MA 12 // Draw of one colour channel at full PWM.
+#    endif // RGB_KERNEL_CHANNEL_MA
+#    ifndef RGB_KERNEL_IDLE_MA
+#        define RGB_KERNEL_IDLE_MA 1 // Draw of a dark LED.
+#    endif // RGB_KERNEL_IDLE_MA
+#    ifndef RGB_KERNEL_PEAK_GAIN
+#        define RGB_KERNEL_PEAK_GAIN ((256 * 255) / RGB_MATRIX_MAXIMUM_BRIGHTNESS) // Q8
+#    endif // RGB_KERNEL_PEAK_GAIN
+
+void rgb_kernel_limit_current(void);
+#else
+#    define rgb_kernel_limit_current()
+#endif // RGB_KERNEL_CURRENT_LIMIT_MA
+
+/**
+ * \brief Push `rgb_kernel_frame[led_min, led_max)` to the LED driver.
+ *
+ * Honors the effect's LED flags, like `RGB_MATRIX_TEST_LED_FLAGS()`.
+ */
+void rgb_kernel_flush(effect_params_t *params, uint8_t led_min, uint8_t led_max);
+
+#ifdef RGB_KERNEL_BENCH_ENABLE
+/**
+ * \brief Per-frame render budget, in cycles.
+ *
+ * Frames that take longer are counted as overruns.  The default is 2% of a
+ * 16 ms frame at 125 MHz, which is what an effect can take without being
+ * noticeable next to matrix scanning.
+ */
+#    ifndef RGB_KERNEL_FRAME_BUDGET_CYCLES
+#        define RGB_KERNEL_FRAME_BUDGET_CYCLES 40000
+#    endif // RGB_KERNEL_FRAME_BUDGET_CYCLES
+
+/** Cycles-per-frame statistics for the custom effects; `users/jobe/tests/test_rgb_effects.c` prints them per effect on the host. */
+typedef struct {
+    uint32_t pending;      // Cycles accumulated for the frame being rendered.
+    uint32_t pending_hash; // Checksum of the LEDs flushed so far this frame.
+    uint32_t last_hash;    // Checksum of the last complete frame.
+    uint32_t last;         // Cycles spent on the last complete frame.
+    uint32_t max;          // Worst frame since the last reset.
+    uint32_t total;        // Sum over `frames`, for the mean.
+    uint16_t frames;
+    uint16_t overruns;  // Frames over RGB_KERNEL_FRAME_BUDGET_CYCLES.
+    uint16_t redundant; // Frames flushed with exactly the previous content.
+    uint16_t limited;   // Half-frames scaled down by the current limiter.
+} rgb_kernel_bench_t;
+
+extern rgb_kernel_bench_t rgb_kernel_bench;
+
+/** Account `cycles` to the current frame; closes it on the effect's last iteration for this half. */
+void rgb_kernel_bench_record(uint32_t cycles, uint8_t led_max);
+
+/** Fold one flushed LED into the frame checksum. */
+void rgb_kernel_bench_hash(uint8_t index, rgb_t color);
+
+/** Print and reset the statistics over the console. */
+void rgb_kernel_bench_report(void);
+
+#endif // RGB_KERNEL_BENCH_ENABLE
+
+#if defined(RGB_KERNEL_BENCH_ENABLE) || defined(PROFILER_ENABLE)
+#    include "profiler.h"
+
+// Every custom effect is timed here, for the frame stats and/or the profiler
+static inline void rgb_kernel_bench_end(uint32_t cycles, uint8_t led_max) {
+#    ifdef RGB_KERNEL_BENCH_ENABLE
+    rgb_kernel_bench_record(cycles, led_max);
+#    endif // RGB_KERNEL_BENCH_ENABLE
+#    ifdef PROFILER_ENABLE
+    profiler_record_effect(rgb_matrix_get_mode(), cycles);
+#    endif // PROFILER_ENABLE
+}
+
+#    define RGB_KERNEL_BENCH_BEGIN() uint32_t rgb_kernel_bench_start_ = timing_read_cycles()
+#    define RGB_KERNEL_BENCH_END(led_max) rgb_kernel_bench_end(timing_cycles_since(rgb_kernel_bench_start_), led_max)
+#else
+#    define RGB_KERNEL_BENCH_BEGIN()
+#    define RGB_KERNEL_BENCH_END(led_max)
+#endif // RGB_KERNEL_BENCH_ENABLE || PROFILER_ENABLE
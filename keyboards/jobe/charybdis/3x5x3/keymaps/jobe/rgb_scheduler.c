@@ -0,0 +1,66 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "rgb_scheduler.h"
+#include "hot_path.h"
+#include "print.h"
+
+rgb_scheduler_stats_t rgb_scheduler_stats;
+
+static uint32_t scheduler_window = 0; // Start of the current one-second window.
+static uint32_t scheduler_scans  = 0;
+static uint8_t  scheduler_frames = 0;
+static bool     scheduler_busy   = false; // Any activity during the window.
+
+static HOT_PATH bool rgb_scheduler_active(void) {
+    return last_input_activity_elapsed() < RGB_SCHEDULER_IDLE_MS;
+}
+
+HOT_PATH uint16_t rgb_scheduler_flush_limit(void) {
+    return rgb_scheduler_active() ? RGB_SCHEDULER_ACTIVE_FLUSH_MS : RGB_SCHEDULER_IDLE_FLUSH_MS;
+}
+
+HOT_PATH void rgb_scheduler_task(void) {
+    scheduler_scans++;
+    scheduler_busy |= rgb_scheduler_active();
+
+    uint32_t elapsed = timer_elapsed32(scheduler_window);
+    if (elapsed < 1000) {
+        return;
+    }
+    uint32_t scan_hz  = scheduler_scans * 1000 / elapsed;
+    uint8_t  frame_hz = (uint32_t)scheduler_frames * 1000 / elapsed;
+    if (scheduler_busy) {
+        rgb_scheduler_stats.scan_hz_active  = scan_hz;
+        rgb_scheduler_stats.frame_hz_active = frame_hz;
+    } else {
+        rgb_scheduler_stats.scan_hz_idle  = scan_hz;
+        rgb_scheduler_stats.frame_hz_idle = frame_hz;
+    }
+
+    scheduler_window = timer_read32();
+    scheduler_scans  = 0;
+    scheduler_frames = 0;
+    scheduler_busy   = false;
+}
+
+HOT_PATH void rgb_scheduler_frame(void) {
+    scheduler_frames++;
+}
+
+void rgb_scheduler_report(void) {
+    uprintf("rgb: busy %lu scans/s %u fps, idle %lu scans/s %u fps\n", (unsigned long)rgb_scheduler_stats.scan_hz_active, rgb_scheduler_stats.frame_hz_active, (unsigned long)rgb_scheduler_stats.scan_hz_idle, rgb_scheduler_stats.frame_hz_idle);
+}
@@ -0,0 +1,62 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+/**
+ * \brief Activity-driven RGB frame rate.
+ *
+ * config.h routes `RGB_MATRIX_LED_FLUSH_LIMIT` here, so the RGB task
+ * renders at `RGB_SCHEDULER_ACTIVE_FLUSH_MS` while keys or the trackball
+ * were used in the last `RGB_SCHEDULER_IDLE_MS`, and at the full
+ * `RGB_SCHEDULER_IDLE_FLUSH_MS` rate otherwise.  Effects must animate from
+ * the clock, not the frame count, to keep their speed.
+ */
+
+#ifndef RGB_SCHEDULER_IDLE_MS
+#    define RGB_SCHEDULER_IDLE_MS 500
+#endif // RGB_SCHEDULER_IDLE_MS
+
+#ifndef RGB_SCHEDULER_ACTIVE_FLUSH_MS
+#    define RGB_SCHEDULER_ACTIVE_FLUSH_MS 50
+#endif // RGB_SCHEDULER_ACTIVE_FLUSH_MS
+
+#ifndef RGB_SCHEDULER_IDLE_FLUSH_MS
+#    define RGB_SCHEDULER_IDLE_FLUSH_MS 16
+#endif // RGB_SCHEDULER_IDLE_FLUSH_MS
+
+typedef struct {
+    uint32_t scan_hz_active; // Main loop rate over the last busy second.
+    uint32_t scan_hz_idle;   // Main loop rate over the last idle second.
+    uint8_t  frame_hz_active;
+    uint8_t  frame_hz_idle;
+} rgb_scheduler_stats_t;
+
+extern rgb_scheduler_stats_t rgb_scheduler_stats;
+
+/** Milliseconds between RGB frames, used as `RGB_MATRIX_LED_FLUSH_LIMIT`. */
+uint16_t rgb_scheduler_flush_limit(void);
+
+/** Count a main loop pass.  Call from housekeeping_task_user. */
+void rgb_scheduler_task(void);
+
+/** Count a rendered frame.  Call from rgb_matrix_indicators_user. */
+void rgb_scheduler_frame(void);
+
+/** Print the scan and frame rates to the console. */
+void rgb_scheduler_report(void);
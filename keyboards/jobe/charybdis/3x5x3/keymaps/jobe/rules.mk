@@ -1,6 +1,19 @@
 VIA_ENABLE = yes
+KEYMAP_CACHE_ENABLE = yes # Keycode lookups from a RAM copy of the VIA keymap
 RGB_MATRIX_ENABLE = yes # Enable RGB Matrix feature
 RGB_MATRIX_CUSTOM_USER = yes # Enable custom user RGB Matrix effects
 
 SRC += utils.c # Add custom source file
-DEFERRED_EXEC_ENABLE = yes
\ No newline at end of file
+SRC += combo_bits.c
+DEFERRED_EXEC_ENABLE = yes
+BOOT_TRACE_ENABLE = yes # Boot phase timestamps, init held back until keys work
+# PROFILER_ENABLE = yes # Per-callback cycle stats, printed with RGB_BNCH
+DEBOUNCE_TYPE = custom # Eager presses, deferred releases (users/jobe/asym_debounce.h)
+
+ifeq ($(strip $(RGB_MATRIX_ENABLE)), yes)
+    SRC += rgb_kernels.c
+    SRC += layer_indicator.c
+    SRC += typing_heatmap.c
+    SRC += rgb_scheduler.c
+    SRC += tap_hold_stats.c
+endif
@@ -44,6 +44,11 @@
 #define SMTD_SIMULTANEOUS_PRESSES_DELAY
 #endif
 
+// Attribute for the per-event functions, eg. to place them in RAM
+#ifndef SMTD_HOT_PATH
+#define SMTD_HOT_PATH
+#endif
+
 #ifndef SMTD_GLOBAL_TAP_TERM
 #define SMTD_GLOBAL_TAP_TERM TAPPING_TERM
 #endif
@@ -397,7 +402,7 @@ uint32_t timeout_release(uint32_t trigger_time, void *cb_arg) {
     return 0;
 }
 
-void smtd_next_stage(smtd_state *state, smtd_stage next_stage) {
+SMTD_HOT_PATH void smtd_next_stage(smtd_state *state, smtd_stage next_stage) {
     #ifdef SMTD_DEBUG_ENABLED
     printf("STAGE by %s, %s -> %s\n", keycode_to_string(state->macro_keycode),
            smtd_stage_to_string(state->stage),smtd_stage_to_string(next_stage));
@@ -472,7 +477,7 @@ void smtd_next_stage(smtd_state *state, smtd_stage next_stage) {
     cancel_deferred_exec(prev_token);
 }
 
-bool process_smtd_state(uint16_t keycode, keyrecord_t *record, smtd_state *state) {
+SMTD_HOT_PATH bool process_smtd_state(uint16_t keycode, keyrecord_t *record, smtd_state *state) {
     if (state->freeze) {
         return true;
     }
@@ -671,7 +676,7 @@ bool process_smtd_state(uint16_t keycode, keyrecord_t *record, smtd_state *state
  *      ENTRY POINT IMPLEMENTATION       *
  * ************************************* */
 
-bool process_smtd(uint16_t keycode, keyrecord_t *record) {
+SMTD_HOT_PATH bool process_smtd(uint16_t keycode, keyrecord_t *record) {
     #ifdef SMTD_DEBUG_ENABLED
     printf("\n>> GOT KEY %s %s\n", keycode_to_string(keycode), record->event.pressed ? "PRESSED" : "RELEASED");
     #endif
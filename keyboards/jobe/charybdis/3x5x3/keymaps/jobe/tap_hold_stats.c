@@ -0,0 +1,114 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tap_hold_stats.h"
+#include "hot_path.h"
+
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+#    include "transactions.h"
+#endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
+
+#define TAP_HOLD_STATS_INSTANT_HUE 85 // Green, fades towards red (0) as the wait grows.
+#define TAP_HOLD_STATS_NO_LED      0xFF
+
+// What gets mirrored to the other half.
+typedef struct {
+    uint8_t led[TAP_HOLD_STATS_KEYS];
+    uint8_t wait[TAP_HOLD_STATS_KEYS]; // Average latency / tap term, 0..255.
+} tap_hold_stats_t;
+
+static tap_hold_stats_t stats = {.led = {[0 ... TAP_HOLD_STATS_KEYS - 1] = TAP_HOLD_STATS_NO_LED}};
+static uint16_t         stats_pressed_at[TAP_HOLD_STATS_KEYS];
+static uint8_t          stats_pending = 0; // Keys pressed and not decided yet.
+static bool             stats_dirty   = true;
+static uint8_t          stats_version = 0; // Bumped on every change, for the split sync.
+
+_Static_assert(TAP_HOLD_STATS_KEYS <= 8, "stats_pending holds at most 8 keys");
+
+HOT_PATH void tap_hold_stats_press(uint8_t key, keyrecord_t *record) {
+    // sm_td replays presses of keys it already holds, only the first one counts
+    if (key >= TAP_HOLD_STATS_KEYS || !record->event.pressed || (stats_pending & (1 << key))) {
+        return;
+    }
+    stats.led[key]        = g_led_config.matrix_co[record->event.key.row][record->event.key.col];
+    stats_pressed_at[key] = timer_read();
+    stats_pending |= 1 << key;
+}
+
+HOT_PATH void tap_hold_stats_decide(uint8_t key, uint16_t tap_term) {
+    if (key >= TAP_HOLD_STATS_KEYS || !(stats_pending & (1 << key))) {
+        return;
+    }
+    stats_pending &= ~(1 << key);
+
+    uint16_t latency = timer_elapsed(stats_pressed_at[key]);
+    uint8_t  sample  = latency >= tap_term ? 255 : ((uint32_t)latency * 255) / tap_term;
+    // Average over the last few decisions (weight 1/4)
+    stats.wait[key] = stats.wait[key] + ((sample - stats.wait[key]) >> 2);
+    stats_dirty     = true;
+    stats_version++;
+}
+
+HOT_PATH void tap_hold_stats_render(bool reset) {
+    if (!reset && !stats_dirty) {
+        return;
+    }
+
+    rgb_kernel_fill(rgb_kernel_frame, (rgb_t){0, 0, 0}, RGB_MATRIX_LED_COUNT);
+    for (uint8_t key = 0; key < TAP_HOLD_STATS_KEYS; key++) {
+        if (stats.led[key] >= RGB_MATRIX_LED_COUNT) {
+            continue;
+        }
+        hsv_t hsv = {
+            .h = TAP_HOLD_STATS_INSTANT_HUE - ((stats.wait[key] * TAP_HOLD_STATS_INSTANT_HUE) >> 8),
+            .s = 255,
+            .v = rgb_matrix_config.hsv.v,
+        };
+        rgb_kernel_frame[stats.led[key]] = rgb_kernel_hsv_to_rgb(hsv);
+    }
+    stats_dirty = false;
+}
+
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+#    ifndef TAP_HOLD_STATS_SYNC_MS
+#        define TAP_HOLD_STATS_SYNC_MS 250
+#    endif // TAP_HOLD_STATS_SYNC_MS
+
+static void tap_hold_stats_receive(uint8_t in_len, const void *in_data, uint8_t out_len, void *out_data) {
+    if (in_len == sizeof(stats)) {
+        memcpy(&stats, in_data, sizeof(stats));
+        stats_dirty = true;
+    }
+}
+
+void tap_hold_stats_init(void) {
+    transaction_register_rpc(RPC_ID_USER_TAP_HOLD_STATS, tap_hold_stats_receive);
+}
+
+void tap_hold_stats_sync(void) {
+    static uint16_t last_sync    = 0;
+    static uint8_t  sent_version = 0;
+
+    // Only the master sees the presses; the slave needs them for its half.
+    if (!is_keyboard_master() || sent_version == stats_version || timer_elapsed(last_sync) < TAP_HOLD_STATS_SYNC_MS) {
+        return;
+    }
+    if (transaction_rpc_send(RPC_ID_USER_TAP_HOLD_STATS, sizeof(stats), &stats)) {
+        sent_version = stats_version;
+        last_sync    = timer_read();
+    }
+}
+#endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
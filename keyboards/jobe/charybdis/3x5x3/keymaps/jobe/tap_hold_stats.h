@@ -0,0 +1,51 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+#include "rgb_kernels.h"
+
+/**
+ * \brief Tap/hold decision latency of the SMTD keys, for the TAP_HOLD_LATENCY effect.
+ *
+ * Each key keeps a running average of the time from its press to sm_td's
+ * tap or hold action, as a fraction of its tap term: 0 is an action right
+ * after the press, whatever triggered it (a quick release, the next key),
+ * and 255 is a wait of the whole tap term or longer.  Keys are indexed from
+ * 0 in SMTD keycode order.
+ */
+
+#ifndef TAP_HOLD_STATS_KEYS
+#    define TAP_HOLD_STATS_KEYS 8
+#endif // TAP_HOLD_STATS_KEYS
+
+/** Note which LED the key is under and when it went down.  Call before process_smtd. */
+void tap_hold_stats_press(uint8_t key, keyrecord_t *record);
+
+/** Record the tap or hold decision for `key`.  Call from on_smtd_action. */
+void tap_hold_stats_decide(uint8_t key, uint16_t tap_term);
+
+/** Colour the SMTD keys green (instant) to red (timeout) in `rgb_kernel_frame`. */
+void tap_hold_stats_render(bool reset);
+
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+/** Register the split transaction.  Call from keyboard_post_init_user. */
+void tap_hold_stats_init(void);
+
+/** Send changed stats to the other half.  Call from housekeeping_task_user. */
+void tap_hold_stats_sync(void);
+#endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
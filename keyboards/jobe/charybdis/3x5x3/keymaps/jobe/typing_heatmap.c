@@ -0,0 +1,195 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "typing_heatmap.h"
+#include "hot_path.h"
+
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+#    include "transactions.h"
+#endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
+
+#define TYPING_HEATMAP_COLD_HUE 170 // Blue, fades towards red (0) as keys warm up.
+
+static uint8_t  heatmap_heat[RGB_MATRIX_LED_COUNT];  // Heat at `heatmap_stamp`.
+static uint32_t heatmap_stamp[RGB_MATRIX_LED_COUNT]; // Last time the cell was written.
+static uint8_t  heatmap_shown[RGB_MATRIX_LED_COUNT]; // Heat currently in the frame.
+static uint64_t heatmap_warm    = 0;                 // Cells with heat left.
+static uint64_t heatmap_pressed = 0;                 // Keys down, so replayed presses count once.
+
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+static uint8_t heatmap_unsent[TYPING_HEATMAP_SYNC_HITS]; // Hits for the other half, oldest first.
+static uint8_t heatmap_unsent_count = 0;
+#endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
+
+#ifdef TYPING_HEATMAP_PERSIST
+static uint16_t       heatmap_counts[RGB_MATRIX_LED_COUNT];
+static bool           heatmap_counts_dirty = true;
+static uint32_t       heatmap_last_hit     = 0;
+static deferred_token heatmap_save_token   = INVALID_DEFERRED_TOKEN;
+_Static_assert(sizeof(heatmap_counts) <= EECONFIG_USER_DATA_SIZE, "EECONFIG_USER_DATA_SIZE too small for the typing heatmap");
+#endif // TYPING_HEATMAP_PERSIST
+
+static HOT_PATH uint8_t heatmap_heat_at(uint8_t led, uint32_t now) {
+    uint32_t cooled = (now - heatmap_stamp[led]) >> TYPING_HEATMAP_DECAY_SHIFT;
+    return cooled >= heatmap_heat[led] ? 0 : heatmap_heat[led] - cooled;
+}
+
+static HOT_PATH rgb_t heatmap_color(uint8_t heat) {
+    if (heat == 0) {
+        return (rgb_t){0, 0, 0};
+    }
+    hsv_t hsv = {
+        .h = TYPING_HEATMAP_COLD_HUE - (uint8_t)((heat * TYPING_HEATMAP_COLD_HUE) >> 8),
+        .s = 255,
+        .v = (uint8_t)((heat * (rgb_matrix_config.hsv.v + 1)) >> 8),
+    };
+    return rgb_kernel_hsv_to_rgb(hsv);
+}
+
+#ifdef TYPING_HEATMAP_PERSIST
+static uint32_t heatmap_save_callback(uint32_t trigger_time, void *cb_arg) {
+    uint32_t quiet = timer_elapsed32(heatmap_last_hit);
+    if (quiet < TYPING_HEATMAP_PERSIST_DELAY) {
+        return TYPING_HEATMAP_PERSIST_DELAY - quiet;
+    }
+    eeconfig_update_user_datablock(heatmap_counts);
+    heatmap_save_token = INVALID_DEFERRED_TOKEN;
+    return 0;
+}
+
+static void heatmap_count(uint8_t led, uint32_t now) {
+    if (++heatmap_counts[led] == UINT16_MAX) {
+        // Keep the proportions rather than clipping the favourite key
+        for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+            heatmap_counts[i] >>= 1;
+        }
+    }
+    heatmap_counts_dirty = true;
+
+    // Written once typing pauses, not on every press
+    heatmap_last_hit = now;
+    if (heatmap_save_token == INVALID_DEFERRED_TOKEN) {
+        heatmap_save_token = defer_exec(TYPING_HEATMAP_PERSIST_DELAY, heatmap_save_callback, NULL);
+    }
+}
+
+void typing_heatmap_init(void) {
+    eeconfig_read_user_datablock(heatmap_counts);
+    heatmap_counts_dirty = true;
+}
+
+void typing_heatmap_render_usage(bool reset) {
+    if (!reset && !heatmap_counts_dirty) {
+        return;
+    }
+
+    uint16_t most = 1;
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        if (heatmap_counts[i] > most) {
+            most = heatmap_counts[i];
+        }
+    }
+    for (uint8_t i = 0; i < RGB_MATRIX_LED_COUNT; i++) {
+        rgb_kernel_frame[i] = heatmap_color((uint8_t)(((uint32_t)heatmap_counts[i] * 255) / most));
+    }
+    heatmap_counts_dirty = false;
+}
+#endif // TYPING_HEATMAP_PERSIST
+
+static HOT_PATH void heatmap_hit(uint8_t led) {
+    uint32_t now  = timer_read32();
+    uint16_t heat = heatmap_heat_at(led, now) + TYPING_HEATMAP_HIT;
+    heatmap_heat[led]  = heat > 255 ? 255 : heat;
+    heatmap_stamp[led] = now;
+    heatmap_warm |= (uint64_t)1 << led;
+
+#ifdef TYPING_HEATMAP_PERSIST
+    heatmap_count(led, now);
+#endif // TYPING_HEATMAP_PERSIST
+}
+
+HOT_PATH void typing_heatmap_record(keyrecord_t *record) {
+    if (record->event.key.row >= MATRIX_ROWS || record->event.key.col >= MATRIX_COLS) {
+        return;
+    }
+    uint8_t led = g_led_config.matrix_co[record->event.key.row][record->event.key.col];
+    if (led >= RGB_MATRIX_LED_COUNT) {
+        return;
+    }
+    uint64_t bit = (uint64_t)1 << led;
+
+    if (!record->event.pressed) {
+        heatmap_pressed &= ~bit;
+        return;
+    }
+    if (heatmap_pressed & bit) {
+        return;
+    }
+    heatmap_pressed |= bit;
+    heatmap_hit(led);
+
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+    // A full queue drops the hit on the other half only, the heat there is a little low
+    if (heatmap_unsent_count < TYPING_HEATMAP_SYNC_HITS) {
+        heatmap_unsent[heatmap_unsent_count++] = led;
+    }
+#endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
+}
+
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+static void typing_heatmap_receive(uint8_t in_len, const void *in_data, uint8_t out_len, void *out_data) {
+    const uint8_t *leds = in_data;
+    for (uint8_t i = 0; i < in_len; i++) {
+        if (leds[i] < RGB_MATRIX_LED_COUNT) {
+            heatmap_hit(leds[i]);
+        }
+    }
+}
+
+void typing_heatmap_split_init(void) {
+    transaction_register_rpc(RPC_ID_USER_TYPING_HEATMAP, typing_heatmap_receive);
+}
+
+void typing_heatmap_sync(void) {
+    // Only the master sees the presses; the slave lights its half from them.
+    if (!is_keyboard_master() || heatmap_unsent_count == 0) {
+        return;
+    }
+    if (transaction_rpc_send(RPC_ID_USER_TYPING_HEATMAP, heatmap_unsent_count, heatmap_unsent)) {
+        heatmap_unsent_count = 0;
+    }
+}
+#endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
+
+HOT_PATH void typing_heatmap_render(bool reset) {
+    if (reset) {
+        rgb_kernel_fill(rgb_kernel_frame, (rgb_t){0, 0, 0}, RGB_MATRIX_LED_COUNT);
+        memset(heatmap_shown, 0, sizeof(heatmap_shown));
+    }
+
+    uint32_t now = timer_read32();
+    for (uint64_t warm = heatmap_warm; warm; warm &= warm - 1) {
+        uint8_t led  = __builtin_ctzll(warm);
+        uint8_t heat = heatmap_heat_at(led, now);
+        if (heat == 0) {
+            heatmap_warm &= ~((uint64_t)1 << led);
+        }
+        if (heat != heatmap_shown[led]) {
+            heatmap_shown[led]    = heat;
+            rgb_kernel_frame[led] = heatmap_color(heat);
+        }
+    }
+}
@@ -0,0 +1,74 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+#include "rgb_kernels.h"
+
+/**
+ * \brief Typing heatmap: every keypress warms its LED, heat cools off over time.
+ *
+ * Each cell stores its heat and the time it was last touched; the current
+ * heat is derived from the elapsed time when the cell is looked at, so idle
+ * cells cost nothing and a frame only touches cells that are still warm.
+ * Hits are recorded on the half running process_record_user; on a split
+ * board with `SPLIT_TRANSACTION_IDS_USER`, the master sends them on to the
+ * other half, like the tap/hold stats.
+ */
+
+#ifndef TYPING_HEATMAP_HIT
+#    define TYPING_HEATMAP_HIT 48 // Heat added per keypress (saturates at 255).
+#endif // TYPING_HEATMAP_HIT
+
+#ifndef TYPING_HEATMAP_DECAY_SHIFT
+#    define TYPING_HEATMAP_DECAY_SHIFT 5 // Lose one unit of heat every 2^n ms.
+#endif // TYPING_HEATMAP_DECAY_SHIFT
+
+/** Warm the LED under a pressed key.  Call from process_record_user. */
+void typing_heatmap_record(keyrecord_t *record);
+
+/**
+ * \brief Update the warm cells of `rgb_kernel_frame`.
+ *
+ * `reset` forces a full redraw, eg. when the effect starts or the
+ * brightness changes.
+ */
+void typing_heatmap_render(bool reset);
+
+#if defined(SPLIT_KEYBOARD) && defined(SPLIT_TRANSACTION_IDS_USER)
+#    ifndef TYPING_HEATMAP_SYNC_HITS
+#        define TYPING_HEATMAP_SYNC_HITS 16 // Hits queued for the other half between two syncs.
+#    endif // TYPING_HEATMAP_SYNC_HITS
+
+/** Register the split transaction.  Call from keyboard_post_init_user. */
+void typing_heatmap_split_init(void);
+
+/** Send the new hits to the other half.  Call from housekeeping_task_user. */
+void typing_heatmap_sync(void);
+#endif // SPLIT_KEYBOARD && SPLIT_TRANSACTION_IDS_USER
+
+#ifdef TYPING_HEATMAP_PERSIST
+#    ifndef TYPING_HEATMAP_PERSIST_DELAY
+#        define TYPING_HEATMAP_PERSIST_DELAY 60000 // Quiet time before counts are written, in ms.
+#    endif // TYPING_HEATMAP_PERSIST_DELAY
+
+/** Load the cumulative per-key counts.  Call from keyboard_post_init_user. */
+void typing_heatmap_init(void);
+
+/** Draw the cumulative counts, relative to the most used key, into `rgb_kernel_frame`. */
+void typing_heatmap_render_usage(bool reset);
+#endif // TYPING_HEATMAP_PERSIST
@@ -1,5 +1,57 @@
-#pragma once
-
-#include QMK_KEYBOARD_H // Needed for types in function signature
-
-// Empty utils.h file for future utility functions 
\ No newline at end of file
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H // Needed for types in function signature
+
+/**
+ * \brief Position of each matrix key in the 36-key layout.
+ *
+ * Built in keymap.c by feeding 1..36 through `LAYOUT`, so it follows the
+ * keyboard's wiring.  0 marks matrix positions without a key; layout index
+ * `i` is stored as `i + 1`.
+ */
+extern const uint8_t PROGMEM layout_positions[MATRIX_ROWS][MATRIX_COLS];
+
+/** Key predicates for `LAYOUT_KEY_MASK`. */
+#define KEY_IS_BOUND(kc) ((uint16_t)(kc) != KC_NO && (uint16_t)(kc) != KC_TRNS)
+#define KEY_IS_MOD(kc)   ((uint16_t)(kc) >= KC_LCTL && (uint16_t)(kc) <= KC_RGUI)
+#define KEY_IS_NAV(kc)   ((uint16_t)(kc) >= KC_INS && (uint16_t)(kc) <= KC_UP)
+#define KEY_IS_FKEY(kc)  ((uint16_t)(kc) >= KC_F1 && (uint16_t)(kc) <= KC_F12)
+
+/**
+ * \brief Compile-time bitmask of the keys of a 36-key layout matching `pred`.
+ *
+ * Bit `i` is layout position `i`, in the order keys are listed in the
+ * `LAYOUT_LAYER_*` macros, eg.:
+ *
+ *     LAYOUT_KEY_MASK(KEY_IS_BOUND, LAYOUT_LAYER_NAVIGATION)
+ */
+#define LAYOUT_KEY_MASK(pred, ...) _LAYOUT_KEY_MASK(pred, __VA_ARGS__)
+#define LAYOUT_KEY_BIT_(pred, kc, i) ((uint64_t)(pred(kc) ? 1 : 0) << (i))
+// clang-format off
+#define _LAYOUT_KEY_MASK(pred, k00, k01, k02, k03, k04, k05, k06, k07, k08, k09, k10, k11, k12, k13, k14, k15, k16, k17, k18, k19, k20, k21, k22, k23, k24, k25, k26, k27, k28, k29, k30, k31, k32, k33, k34, k35) \
+    (LAYOUT_KEY_BIT_(pred, k00, 0) | LAYOUT_KEY_BIT_(pred, k01, 1) | LAYOUT_KEY_BIT_(pred, k02, 2) | LAYOUT_KEY_BIT_(pred, k03, 3) | \
+     LAYOUT_KEY_BIT_(pred, k04, 4) | LAYOUT_KEY_BIT_(pred, k05, 5) | LAYOUT_KEY_BIT_(pred, k06, 6) | LAYOUT_KEY_BIT_(pred, k07, 7) | \
+     LAYOUT_KEY_BIT_(pred, k08, 8) | LAYOUT_KEY_BIT_(pred, k09, 9) | LAYOUT_KEY_BIT_(pred, k10, 10) | LAYOUT_KEY_BIT_(pred, k11, 11) | \
+     LAYOUT_KEY_BIT_(pred, k12, 12) | LAYOUT_KEY_BIT_(pred, k13, 13) | LAYOUT_KEY_BIT_(pred, k14, 14) | LAYOUT_KEY_BIT_(pred, k15, 15) | \
+     LAYOUT_KEY_BIT_(pred, k16, 16) | LAYOUT_KEY_BIT_(pred, k17, 17) | LAYOUT_KEY_BIT_(pred, k18, 18) | LAYOUT_KEY_BIT_(pred, k19, 19) | \
+     LAYOUT_KEY_BIT_(pred, k20, 20) | LAYOUT_KEY_BIT_(pred, k21, 21) | LAYOUT_KEY_BIT_(pred, k22, 22) | LAYOUT_KEY_BIT_(pred, k23, 23) | \
+     LAYOUT_KEY_BIT_(pred, k24, 24) | LAYOUT_KEY_BIT_(pred, k25, 25) | LAYOUT_KEY_BIT_(pred, k26, 26) | LAYOUT_KEY_BIT_(pred, k27, 27) | \
+     LAYOUT_KEY_BIT_(pred, k28, 28) | LAYOUT_KEY_BIT_(pred, k29, 29) | LAYOUT_KEY_BIT_(pred, k30, 30) | LAYOUT_KEY_BIT_(pred, k31, 31) | \
+     LAYOUT_KEY_BIT_(pred, k32, 32) | LAYOUT_KEY_BIT_(pred, k33, 33) | LAYOUT_KEY_BIT_(pred, k34, 34) | LAYOUT_KEY_BIT_(pred, k35, 35))
+// clang-format on
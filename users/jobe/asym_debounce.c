@@ -0,0 +1,120 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "asym_debounce.h"
+#include "debounce.h"
+#include "hot_path.h"
+#include "print.h"
+
+#define ASYM_DEBOUNCE_KEYS (MATRIX_ROWS * MATRIX_COLS)
+
+asym_debounce_stats_t asym_debounce_stats;
+
+static matrix_row_t debounce_pending[MATRIX_ROWS];          // Keys with a release waiting out DEBOUNCE.
+static uint8_t      debounce_left[ASYM_DEBOUNCE_KEYS];      // ms before the pending release is sent.
+static fast_timer_t debounce_pressed_at[ASYM_DEBOUNCE_KEYS];
+static fast_timer_t debounce_last;
+static bool         debounce_counting = false;
+
+void debounce_init(uint8_t num_rows) {
+    memset(debounce_pending, 0, sizeof(debounce_pending));
+    debounce_counting = false;
+}
+
+void debounce_free(void) {}
+
+// Count down the pending releases, sending those that ran out
+static HOT_PATH bool debounce_tick(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, uint8_t elapsed) {
+    bool changed = false;
+    bool pending = false;
+    for (uint8_t row = 0; row < num_rows; row++) {
+        for (matrix_row_t keys = debounce_pending[row]; keys; keys &= keys - 1) {
+            uint8_t      col = __builtin_ctz(keys);
+            matrix_row_t bit = (matrix_row_t)1 << col;
+            uint8_t      key = row * MATRIX_COLS + col;
+
+            if (debounce_left[key] <= elapsed) {
+                debounce_pending[row] &= ~bit;
+                cooked[row] &= ~bit;
+                changed = true;
+                asym_debounce_stats.releases++;
+                if (TIMER_DIFF_FAST(debounce_last, debounce_pressed_at[key]) < ASYM_DEBOUNCE_SPURIOUS_MS + DEBOUNCE) {
+                    asym_debounce_stats.spurious++;
+                }
+            } else {
+                debounce_left[key] -= elapsed;
+            }
+        }
+        pending |= debounce_pending[row] != 0;
+    }
+    debounce_counting = pending;
+    return changed;
+}
+
+HOT_PATH bool debounce(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool cooked_changed = false;
+
+    if (changed) {
+        // Closed again before the release settled: chatter, keep the key down
+        for (uint8_t row = 0; row < num_rows; row++) {
+            matrix_row_t reclosed = debounce_pending[row] & raw[row];
+            if (reclosed) {
+                debounce_pending[row] &= ~reclosed;
+                asym_debounce_stats.bounces += __builtin_popcount(reclosed);
+            }
+        }
+    }
+
+    if (debounce_counting) {
+        fast_timer_t now     = timer_read_fast();
+        uint16_t     elapsed = TIMER_DIFF_FAST(now, debounce_last);
+        debounce_last        = now;
+        if (elapsed > 0) {
+            cooked_changed = debounce_tick(raw, cooked, num_rows, elapsed > UINT8_MAX ? UINT8_MAX : elapsed);
+        }
+    }
+
+    if (changed) {
+        for (uint8_t row = 0; row < num_rows; row++) {
+            matrix_row_t delta = (raw[row] ^ cooked[row]) & ~debounce_pending[row];
+            for (; delta; delta &= delta - 1) {
+                uint8_t      col = __builtin_ctz(delta);
+                matrix_row_t bit = (matrix_row_t)1 << col;
+                uint8_t      key = row * MATRIX_COLS + col;
+
+                if (raw[row] & bit) {
+                    cooked[row] |= bit;
+                    cooked_changed = true;
+                    debounce_pressed_at[key] = timer_read_fast();
+                    asym_debounce_stats.presses++;
+                } else {
+                    if (!debounce_counting) {
+                        debounce_last     = timer_read_fast();
+                        debounce_counting = true;
+                    }
+                    debounce_pending[row] |= bit;
+                    debounce_left[key] = DEBOUNCE;
+                }
+            }
+        }
+    }
+
+    return cooked_changed;
+}
+
+void asym_debounce_report(void) {
+    uprintf("debounce: %lu presses, %lu releases, %lu bounces absorbed, %lu probable noise presses\n", (unsigned long)asym_debounce_stats.presses, (unsigned long)asym_debounce_stats.releases, (unsigned long)asym_debounce_stats.bounces, (unsigned long)asym_debounce_stats.spurious);
+}
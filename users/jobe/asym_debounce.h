@@ -0,0 +1,52 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+/**
+ * \brief Per-key debounce that sends presses at once and holds releases back.
+ *
+ * A key closing is reported on the first scan that sees it, so a press
+ * reaches sm_td at least `DEBOUNCE` ms earlier than with the stock
+ * `sym_defer_g`, and more while other keys chatter (tests/test_asym_debounce.c
+ * prints both on the same bounce traces).  A
+ * key opening is only reported once it has stayed open for `DEBOUNCE` ms;
+ * contact chatter during that window cancels the release instead of
+ * producing an extra tap.  Enabled with `DEBOUNCE_TYPE = custom` in the
+ * keymap's rules.mk.
+ */
+
+#ifndef DEBOUNCE
+#    define DEBOUNCE 5
+#endif // DEBOUNCE
+
+#ifndef ASYM_DEBOUNCE_SPURIOUS_MS
+#    define ASYM_DEBOUNCE_SPURIOUS_MS 10 // Presses shorter than this are counted as probable noise.
+#endif // ASYM_DEBOUNCE_SPURIOUS_MS
+
+typedef struct {
+    uint32_t presses;
+    uint32_t releases;
+    uint32_t bounces;  // Releases cancelled by the key closing again within DEBOUNCE.
+    uint32_t spurious; // Presses held under ASYM_DEBOUNCE_SPURIOUS_MS, that a deferred press would have filtered.
+} asym_debounce_stats_t;
+
+extern asym_debounce_stats_t asym_debounce_stats;
+
+/** Print the counters. */
+void asym_debounce_report(void);
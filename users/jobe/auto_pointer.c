@@ -0,0 +1,84 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "auto_pointer.h"
+
+// Energy is kept in 1/16 counts so the leak does not stall on small values.
+#define AUTO_POINTER_ENERGY_SHIFT 4
+// Milliseconds of motion credit kept while the ball rests, so reports a few
+// milliseconds apart still count at the full rate.
+#define AUTO_POINTER_CREDIT_MS 4
+
+static uint32_t       auto_pointer_energy = 0;
+static uint32_t       auto_pointer_credit = 0; // Motion the energy may still take in, refilled over time.
+static uint16_t       auto_pointer_sample = 0; // Time of the last report.
+static uint16_t       auto_pointer_moving = 0; // Last time the energy was above the exit threshold.
+static uint8_t        auto_pointer_layer  = 0;
+static deferred_token auto_pointer_token  = INVALID_DEFERRED_TOKEN;
+
+static uint32_t auto_pointer_timeout(uint32_t trigger_time, void *cb_arg) {
+    uint16_t idle = timer_elapsed(auto_pointer_moving);
+    if (idle < AUTO_POINTER_TIMEOUT_MS) {
+        return AUTO_POINTER_TIMEOUT_MS - idle;
+    }
+    layer_off(auto_pointer_layer);
+    auto_pointer_token = INVALID_DEFERRED_TOKEN;
+    return 0;
+}
+
+void auto_pointer_task(report_mouse_t *mouse_report, uint8_t layer) {
+    uint16_t now     = timer_read();
+    uint16_t elapsed = TIMER_DIFF_16(now, auto_pointer_sample);
+    auto_pointer_sample = now;
+
+    // Leak, then add this report's motion
+    if (elapsed >= (1 << AUTO_POINTER_DECAY_SHIFT)) {
+        auto_pointer_energy = 0;
+    } else {
+        uint32_t leak = (auto_pointer_energy * elapsed) >> AUTO_POINTER_DECAY_SHIFT;
+        if (leak == 0 && elapsed > 0) {
+            leak = 1;
+        }
+        auto_pointer_energy = leak < auto_pointer_energy ? auto_pointer_energy - leak : 0;
+    }
+
+    // Motion counts up to AUTO_POINTER_RATE_CAP a millisecond, however many
+    // reports it comes in
+    uint32_t rate   = AUTO_POINTER_RATE_CAP << AUTO_POINTER_ENERGY_SHIFT;
+    uint32_t credit = auto_pointer_credit + (elapsed < AUTO_POINTER_CREDIT_MS ? elapsed : AUTO_POINTER_CREDIT_MS) * rate;
+    if (credit > AUTO_POINTER_CREDIT_MS * rate) {
+        credit = AUTO_POINTER_CREDIT_MS * rate;
+    }
+    uint32_t motion = (uint32_t)(abs(mouse_report->x) + abs(mouse_report->y)) << AUTO_POINTER_ENERGY_SHIFT;
+    if (motion > credit) {
+        motion = credit;
+    }
+    auto_pointer_credit = credit - motion;
+    auto_pointer_energy += motion;
+
+    if (auto_pointer_energy < (AUTO_POINTER_EXIT_THRESHOLD << AUTO_POINTER_ENERGY_SHIFT)) {
+        return;
+    }
+    auto_pointer_moving = now;
+
+    if (auto_pointer_token == INVALID_DEFERRED_TOKEN && auto_pointer_energy >= (AUTO_POINTER_ENTER_THRESHOLD << AUTO_POINTER_ENERGY_SHIFT)) {
+        auto_pointer_layer = layer;
+        auto_pointer_token = defer_exec(AUTO_POINTER_TIMEOUT_MS, auto_pointer_timeout, NULL);
+        if (auto_pointer_token != INVALID_DEFERRED_TOKEN) {
+            layer_on(layer);
+        }
+    }
+}
@@ -0,0 +1,60 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+/**
+ * \brief Trackball-activated pointer layer, shared by the Charybdis and Dilemma keymaps.
+ *
+ * Motion feeds an energy accumulator (|x| + |y| per report) that leaks with a
+ * time constant of 2^`AUTO_POINTER_DECAY_SHIFT` ms.  The layer turns on above
+ * `AUTO_POINTER_ENTER_THRESHOLD` and stays on while the energy is above
+ * `AUTO_POINTER_EXIT_THRESHOLD`; it turns off `AUTO_POINTER_TIMEOUT_MS` after
+ * that, from a deferred callback.
+ *
+ * The energy takes in at most `AUTO_POINTER_RATE_CAP` counts a millisecond,
+ * whatever the report rate, so however fast the ball moves it takes time to
+ * reach the enter threshold.  With rate cap r, a time constant T, an enter
+ * threshold E and the few counts banked while the ball rests (B), that is
+ * about T * ln((rT - B) / (rT - E)) ms.  Bumps of the ball shorter than that
+ * never turn the layer on; with the defaults it is 25 ms.  Motion slower than
+ * E / T counts a millisecond never does either.
+ */
+
+#ifndef AUTO_POINTER_ENTER_THRESHOLD
+#    define AUTO_POINTER_ENTER_THRESHOLD 24
+#endif // AUTO_POINTER_ENTER_THRESHOLD
+
+#ifndef AUTO_POINTER_EXIT_THRESHOLD
+#    define AUTO_POINTER_EXIT_THRESHOLD 8
+#endif // AUTO_POINTER_EXIT_THRESHOLD
+
+#ifndef AUTO_POINTER_RATE_CAP
+#    define AUTO_POINTER_RATE_CAP 1 // Counts per millisecond.
+#endif // AUTO_POINTER_RATE_CAP
+
+#ifndef AUTO_POINTER_DECAY_SHIFT
+#    define AUTO_POINTER_DECAY_SHIFT 6
+#endif // AUTO_POINTER_DECAY_SHIFT
+
+#ifndef AUTO_POINTER_TIMEOUT_MS
+#    define AUTO_POINTER_TIMEOUT_MS 1000
+#endif // AUTO_POINTER_TIMEOUT_MS
+
+/** Feed a mouse report; turns `layer` on and schedules turning it off. */
+void auto_pointer_task(report_mouse_t *mouse_report, uint8_t layer);
@@ -0,0 +1,107 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "boot_trace.h"
+#include "timing.h"
+#include "print.h"
+
+typedef struct {
+    uint32_t     us;
+    boot_phase_t phase;
+} boot_trace_entry_t;
+
+static const char *const boot_phase_names[BOOT_PHASE_COUNT] = {
+    [BOOT_PHASE_PRE_INIT]       = "pre init",
+    [BOOT_PHASE_POST_INIT]      = "post init",
+    [BOOT_PHASE_FIRST_SCAN]     = "first scan",
+    [BOOT_PHASE_FIRST_KEY]      = "first key",
+    [BOOT_PHASE_DEFERRED_START] = "deferred init",
+    [BOOT_PHASE_DEFERRED_DONE]  = "deferred done",
+    [BOOT_PHASE_SUSPEND]        = "suspend",
+    [BOOT_PHASE_WAKEUP]         = "wake-up",
+};
+
+static boot_trace_entry_t boot_trace_ring[BOOT_TRACE_ENTRIES];
+static uint8_t            boot_trace_next  = 0;
+static uint8_t            boot_trace_count = 0;
+
+static bool           boot_first_scan     = true;
+static bool           boot_first_key      = true;
+static deferred_token boot_deferred_token = INVALID_DEFERRED_TOKEN;
+static void (*boot_deferred)(void)        = NULL;
+static uint32_t boot_first_scan_us          = 0;
+static uint32_t boot_deferred_us            = 0; // How long the deferred init took.
+
+void boot_trace_mark(boot_phase_t phase) {
+    boot_trace_ring[boot_trace_next] = (boot_trace_entry_t){.us = timing_read_us(), .phase = phase};
+    boot_trace_next                  = (boot_trace_next + 1) % BOOT_TRACE_ENTRIES;
+    if (boot_trace_count < BOOT_TRACE_ENTRIES) {
+        boot_trace_count++;
+    }
+    if (phase == BOOT_PHASE_WAKEUP) {
+        boot_first_key = true;
+    }
+}
+
+static uint32_t boot_deferred_callback(uint32_t trigger_time, void *cb_arg) {
+    boot_deferred_token = INVALID_DEFERRED_TOKEN;
+    boot_trace_mark(BOOT_PHASE_DEFERRED_START);
+    uint32_t start = timing_read_us();
+    boot_deferred();
+    boot_deferred_us = timing_read_us() - start;
+    boot_trace_mark(BOOT_PHASE_DEFERRED_DONE);
+    return 0;
+}
+
+void boot_trace_defer(void (*init)(void)) {
+    boot_deferred       = init;
+    boot_deferred_token = defer_exec(BOOT_TRACE_DEFER_MS, boot_deferred_callback, NULL);
+    if (boot_deferred_token == INVALID_DEFERRED_TOKEN) {
+        boot_deferred_callback(0, NULL); // No executor free, don't lose the init
+    }
+}
+
+void boot_trace_task(void) {
+    if (boot_first_scan) {
+        boot_first_scan    = false;
+        boot_first_scan_us = timing_read_us();
+        boot_trace_mark(BOOT_PHASE_FIRST_SCAN);
+    }
+}
+
+void boot_trace_key(void) {
+    if (!boot_first_key) {
+        return;
+    }
+    boot_first_key = false;
+    boot_trace_mark(BOOT_PHASE_FIRST_KEY);
+    // Once this event's report is out
+    if (boot_deferred_token != INVALID_DEFERRED_TOKEN) {
+        extend_deferred_exec(boot_deferred_token, 1);
+    }
+}
+
+void boot_trace_report(void) {
+    uint8_t first = (boot_trace_next + BOOT_TRACE_ENTRIES - boot_trace_count) % BOOT_TRACE_ENTRIES;
+    for (uint8_t i = 0; i < boot_trace_count; i++) {
+        const boot_trace_entry_t *entry = &boot_trace_ring[(first + i) % BOOT_TRACE_ENTRIES];
+        uprintf("boot: %10lu us %s\n", (unsigned long)entry->us, boot_phase_names[entry->phase]);
+    }
+    // Run from keyboard_post_init_user, the deferred init would hold up the first scan by its duration
+    if (boot_deferred_us) {
+        uprintf("boot: keys read from %lu us, %lu us without deferring %lu us of init\n", (unsigned long)boot_first_scan_us, (unsigned long)(boot_first_scan_us + boot_deferred_us), (unsigned long)boot_deferred_us);
+    }
+}
@@ -0,0 +1,73 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+/**
+ * \brief Boot phase timestamps, and init work held back until keys work.
+ *
+ * `boot_trace_mark` stamps a phase with `timing_read_us`, which counts from
+ * the MCU reset on the RP2040, into a ring of the last
+ * `BOOT_TRACE_ENTRIES` marks; waking from suspend adds to the same ring.
+ *
+ * Init work the first key press does not need (loading caches, starting
+ * RGB effects, reading statistics from EEPROM) goes to `boot_trace_defer`.
+ * It runs `BOOT_TRACE_DEFER_MS` after keyboard_post_init_user, or right
+ * after the first key event if that comes earlier, so that key's report is
+ * not held up by it.
+ */
+
+#ifndef BOOT_TRACE_ENTRIES
+#    define BOOT_TRACE_ENTRIES 16
+#endif // BOOT_TRACE_ENTRIES
+
+#ifndef BOOT_TRACE_DEFER_MS
+#    define BOOT_TRACE_DEFER_MS 250
+#endif // BOOT_TRACE_DEFER_MS
+
+typedef enum {
+    BOOT_PHASE_PRE_INIT,
+    BOOT_PHASE_POST_INIT,
+    BOOT_PHASE_FIRST_SCAN, // First main loop pass, after the first matrix scan.
+    BOOT_PHASE_FIRST_KEY,  // First key event since boot or wake-up.
+    BOOT_PHASE_DEFERRED_START,
+    BOOT_PHASE_DEFERRED_DONE,
+    BOOT_PHASE_SUSPEND,
+    BOOT_PHASE_WAKEUP,
+    BOOT_PHASE_COUNT,
+} boot_phase_t;
+
+/** Stamp `phase`. */
+void boot_trace_mark(boot_phase_t phase);
+
+/** Run `init` once the keyboard is up, see above.  Call from keyboard_post_init_user. */
+void boot_trace_defer(void (*init)(void));
+
+/** Stamp the first main loop pass.  Call from housekeeping_task_user. */
+void boot_trace_task(void);
+
+/** Stamp the first key event and start the deferred init.  Call from process_record_user. */
+void boot_trace_key(void);
+
+/**
+ * \brief Print the marks to the console, oldest first.
+ *
+ * Once the deferred init ran, also prints when keys were first read, next
+ * to when they would have been with that init left in keyboard_post_init_user.
+ */
+void boot_trace_report(void);
@@ -0,0 +1,135 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "drag_scroll.h"
+
+#ifdef POINTING_DEVICE_HIRES_SCROLL_ENABLE
+#    ifndef POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER
+#        define POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER 120
+#    endif // POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER
+#    define DRAG_SCROLL_UNITS_PER_DETENT POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER
+#else
+#    define DRAG_SCROLL_UNITS_PER_DETENT 1
+#endif // POINTING_DEVICE_HIRES_SCROLL_ENABLE
+
+// Q8 wheel units per ball count.
+#define DRAG_SCROLL_GAIN ((DRAG_SCROLL_UNITS_PER_DETENT * 256) / DRAG_SCROLL_COUNTS_PER_DETENT)
+
+#ifdef WHEEL_EXTENDED_REPORT
+#    define DRAG_SCROLL_HV_MAX INT16_MAX
+#else
+#    define DRAG_SCROLL_HV_MAX INT8_MAX
+#endif // WHEEL_EXTENDED_REPORT
+
+typedef struct {
+    int32_t pending;  // Q8 wheel units not sent yet.
+    int32_t velocity; // Q8 wheel units per tick.
+    int32_t moved;    // Q8 wheel units the ball made during this tick.
+} drag_scroll_axis_t;
+
+static drag_scroll_axis_t drag_scroll_h;
+static drag_scroll_axis_t drag_scroll_v;
+static bool               drag_scroll_enabled = false;
+
+#ifdef DRAG_SCROLL_MOMENTUM
+static deferred_token drag_scroll_token = INVALID_DEFERRED_TOKEN;
+
+// Returns whether the axis is still moving.
+static bool drag_scroll_tick_axis(drag_scroll_axis_t *axis) {
+    if (axis->moved != 0) {
+        // Ball moving: average the velocity over the last ticks
+        axis->velocity = (axis->velocity + axis->moved) / 2;
+        axis->moved    = 0;
+        return true;
+    }
+    if (drag_scroll_enabled) {
+        // Ball held still: no coasting until it is let go
+        axis->velocity = 0;
+        return false;
+    }
+    // Ball released: coast
+    axis->pending += axis->velocity;
+    axis->velocity -= axis->velocity >> DRAG_SCROLL_DECAY_SHIFT;
+    if (axis->velocity > -(1 << 8) && axis->velocity < (1 << 8)) {
+        axis->velocity = 0;
+    }
+    return axis->velocity != 0;
+}
+
+static uint32_t drag_scroll_tick(uint32_t trigger_time, void *cb_arg) {
+    bool moving = drag_scroll_tick_axis(&drag_scroll_h);
+    moving |= drag_scroll_tick_axis(&drag_scroll_v);
+    if (drag_scroll_enabled || moving) {
+        return DRAG_SCROLL_TICK_MS;
+    }
+    drag_scroll_token = INVALID_DEFERRED_TOKEN;
+    return 0;
+}
+#endif // DRAG_SCROLL_MOMENTUM
+
+void drag_scroll_set_enabled(bool enabled) {
+    drag_scroll_enabled = enabled;
+    if (enabled) {
+        // Grabbing the ball again stops any coasting
+        drag_scroll_h = (drag_scroll_axis_t){0};
+        drag_scroll_v = (drag_scroll_axis_t){0};
+#ifdef DRAG_SCROLL_MOMENTUM
+        if (drag_scroll_token == INVALID_DEFERRED_TOKEN) {
+            drag_scroll_token = defer_exec(DRAG_SCROLL_TICK_MS, drag_scroll_tick, NULL);
+        }
+#endif // DRAG_SCROLL_MOMENTUM
+    }
+}
+
+bool drag_scroll_is_enabled(void) {
+    return drag_scroll_enabled;
+}
+
+static mouse_hv_report_t drag_scroll_drain(drag_scroll_axis_t *axis, mouse_hv_report_t wheel) {
+    int32_t units = axis->pending / 256; // Rounds towards zero, the rest stays pending.
+    int32_t total = wheel + units;
+    if (total > DRAG_SCROLL_HV_MAX) {
+        units = DRAG_SCROLL_HV_MAX - wheel;
+    } else if (total < -DRAG_SCROLL_HV_MAX) {
+        units = -DRAG_SCROLL_HV_MAX - wheel;
+    }
+    axis->pending -= units * 256;
+    return wheel + units;
+}
+
+void drag_scroll_task(report_mouse_t *mouse_report) {
+    if (drag_scroll_enabled) {
+#if defined(DRAG_SCROLL_REVERSE_X) || defined(CHARYBDIS_DRAGSCROLL_REVERSE_X)
+        int32_t h = -(int32_t)mouse_report->x * DRAG_SCROLL_GAIN;
+#else
+        int32_t h = (int32_t)mouse_report->x * DRAG_SCROLL_GAIN;
+#endif // DRAG_SCROLL_REVERSE_X
+#if defined(DRAG_SCROLL_REVERSE_Y) || defined(CHARYBDIS_DRAGSCROLL_REVERSE_Y)
+        int32_t v = -(int32_t)mouse_report->y * DRAG_SCROLL_GAIN;
+#else
+        int32_t v = (int32_t)mouse_report->y * DRAG_SCROLL_GAIN;
+#endif // DRAG_SCROLL_REVERSE_Y
+        drag_scroll_h.pending += h;
+        drag_scroll_v.pending += v;
+        drag_scroll_h.moved += h;
+        drag_scroll_v.moved += v;
+        mouse_report->x = 0;
+        mouse_report->y = 0;
+    }
+    // Also drains what momentum adds after the ball is released
+    mouse_report->h = drag_scroll_drain(&drag_scroll_h, mouse_report->h);
+    mouse_report->v = drag_scroll_drain(&drag_scroll_v, mouse_report->v);
+}
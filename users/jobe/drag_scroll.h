@@ -0,0 +1,50 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+/**
+ * \brief Smooth drag-scroll, replacing the Charybdis driver's coarse one.
+ *
+ * Ball counts become wheel units through a Q8 gain, with the remainder
+ * carried to the next report, so no motion is lost.  With
+ * `POINTING_DEVICE_HIRES_SCROLL_ENABLE` a detent is split into
+ * `POINTING_DEVICE_HIRES_SCROLL_MULTIPLIER` units.  With
+ * `DRAG_SCROLL_MOMENTUM`, a deferred callback keeps scrolling after the key
+ * is let go, decaying the last velocity every `DRAG_SCROLL_TICK_MS`.
+ */
+
+#ifndef DRAG_SCROLL_COUNTS_PER_DETENT
+#    define DRAG_SCROLL_COUNTS_PER_DETENT 48 // Ball counts per wheel detent.
+#endif // DRAG_SCROLL_COUNTS_PER_DETENT
+
+#ifndef DRAG_SCROLL_TICK_MS
+#    define DRAG_SCROLL_TICK_MS 10
+#endif // DRAG_SCROLL_TICK_MS
+
+#ifndef DRAG_SCROLL_DECAY_SHIFT
+#    define DRAG_SCROLL_DECAY_SHIFT 4 // Lose 1/16 of the velocity per tick.
+#endif // DRAG_SCROLL_DECAY_SHIFT
+
+/** Start or stop scrolling with the ball, eg. on DRGSCRL press and release. */
+void drag_scroll_set_enabled(bool enabled);
+
+bool drag_scroll_is_enabled(void);
+
+/** Turn the report's x/y into h/v while enabled.  Call from pointing_device_task_user. */
+void drag_scroll_task(report_mouse_t *mouse_report);
@@ -0,0 +1,89 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "flick_gesture.h"
+
+static bool     flick_armed  = false;
+static bool     flick_fired  = false; // Waiting for the ball to rest.
+static int16_t  flick_x      = 0;
+static int16_t  flick_y      = 0;
+static uint16_t flick_start  = 0; // First motion of the current stroke.
+static uint16_t flick_motion = 0; // Last motion of any kind.
+
+static void flick_reset(void) {
+    flick_x     = 0;
+    flick_y     = 0;
+    flick_fired = false;
+}
+
+void flick_gesture_set_armed(bool armed) {
+    flick_armed = armed;
+    flick_reset();
+}
+
+static int16_t flick_add(int16_t sum, mouse_xy_report_t delta) {
+    int32_t next = (int32_t)sum + delta;
+    return next > INT16_MAX ? INT16_MAX : next < -INT16_MAX ? -INT16_MAX : next;
+}
+
+// Axis that dominates by at least 3:2, or none for diagonal strokes.
+static flick_direction_t flick_quantize(int16_t x, int16_t y) {
+    uint16_t ax = x < 0 ? -x : x;
+    uint16_t ay = y < 0 ? -y : y;
+    if (ax >= FLICK_GESTURE_DISTANCE && 2 * (uint32_t)ax >= 3 * (uint32_t)ay) {
+        return x < 0 ? FLICK_LEFT : FLICK_RIGHT;
+    }
+    if (ay >= FLICK_GESTURE_DISTANCE && 2 * (uint32_t)ay >= 3 * (uint32_t)ax) {
+        return y < 0 ? FLICK_UP : FLICK_DOWN;
+    }
+    return FLICK_NONE;
+}
+
+flick_direction_t flick_gesture_task(report_mouse_t *mouse_report) {
+    if (!flick_armed) {
+        return FLICK_NONE;
+    }
+    mouse_xy_report_t x = mouse_report->x;
+    mouse_xy_report_t y = mouse_report->y;
+    mouse_report->x     = 0;
+    mouse_report->y     = 0;
+
+    if (x == 0 && y == 0) {
+        if (timer_elapsed(flick_motion) >= FLICK_GESTURE_REARM_MS) {
+            flick_reset();
+        }
+        return FLICK_NONE;
+    }
+    flick_motion = timer_read();
+    if (flick_fired) {
+        return FLICK_NONE;
+    }
+
+    if ((flick_x == 0 && flick_y == 0) || timer_elapsed(flick_start) > FLICK_GESTURE_WINDOW_MS) {
+        // New stroke, or the last one was too slow to count
+        flick_x     = 0;
+        flick_y     = 0;
+        flick_start = flick_motion;
+    }
+    flick_x = flick_add(flick_x, x);
+    flick_y = flick_add(flick_y, y);
+
+    flick_direction_t direction = flick_quantize(flick_x, flick_y);
+    if (direction != FLICK_NONE) {
+        flick_fired = true;
+    }
+    return direction;
+}
@@ -0,0 +1,61 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+/**
+ * \brief Trackball flicks as keys.
+ *
+ * While armed, eg. by holding a key, ball motion no longer moves the cursor.
+ * A short fast flick fires once: `FLICK_GESTURE_DISTANCE` counts within
+ * `FLICK_GESTURE_WINDOW_MS`, mostly along one axis.  The next flick needs the
+ * ball to rest for `FLICK_GESTURE_REARM_MS` first.  Each report costs a few
+ * adds and compares, with no buffers.
+ */
+
+#ifndef FLICK_GESTURE_DISTANCE
+#    define FLICK_GESTURE_DISTANCE 120 // Sensor counts.
+#endif // FLICK_GESTURE_DISTANCE
+
+#ifndef FLICK_GESTURE_WINDOW_MS
+#    define FLICK_GESTURE_WINDOW_MS 150 // Slower motion is not a flick.
+#endif // FLICK_GESTURE_WINDOW_MS
+
+#ifndef FLICK_GESTURE_REARM_MS
+#    define FLICK_GESTURE_REARM_MS 150
+#endif // FLICK_GESTURE_REARM_MS
+
+typedef enum {
+    FLICK_NONE,
+    FLICK_LEFT,
+    FLICK_RIGHT,
+    FLICK_UP,
+    FLICK_DOWN,
+    FLICK_DIRECTION_COUNT,
+} flick_direction_t;
+
+/** Start or stop catching flicks, eg. on the gesture key's press and release. */
+void flick_gesture_set_armed(bool armed);
+
+/**
+ * \brief Swallow the report's x/y while armed and classify it.
+ *
+ * Returns the direction when a flick completes, `FLICK_NONE` otherwise.
+ * Call from pointing_device_task_user, before acceleration.
+ */
+flick_direction_t flick_gesture_task(report_mouse_t *mouse_report);
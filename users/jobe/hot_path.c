@@ -0,0 +1,39 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "hot_path.h"
+#include "print.h"
+#include "timing.h"
+
+hot_path_stats_t hot_path_stats;
+
+void hot_path_measure(uint32_t start) {
+    uint32_t cycles = timing_cycles_since(start);
+    if (cycles > hot_path_stats.worst_cycles) {
+        hot_path_stats.worst_cycles = cycles;
+    }
+    hot_path_stats.events++;
+}
+
+void hot_path_report(void) {
+#if defined(MCU_RP) && !defined(HOT_PATH_DISABLE)
+    const char *where = "RAM";
+#else
+    const char *where = "flash";
+#endif // MCU_RP && !HOT_PATH_DISABLE
+    uprintf("hot path (%s): %lu events, worst %lu cycles\n", where, (unsigned long)hot_path_stats.events, (unsigned long)hot_path_stats.worst_cycles);
+    hot_path_stats.worst_cycles = 0;
+}
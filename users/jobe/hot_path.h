@@ -0,0 +1,50 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * \brief Keep the per-keypress and per-frame code in SRAM on the RP2040.
+ *
+ * The RP2040 runs code from QSPI flash through a 16 kB XIP cache, so a
+ * function evicted by a burst of RGB or USB work costs a flash fetch the
+ * next time a key is pressed.  `HOT_PATH` places a function in the
+ * `.time_critical.*` sections that the RP2040 linker script copies to RAM at
+ * boot; it expands to nothing on other MCUs or with `HOT_PATH_DISABLE`.
+ * The RAM cost shows up under `.time_critical.jobe` in the build's `.map`
+ * file.
+ */
+
+#if defined(MCU_RP) && !defined(HOT_PATH_DISABLE)
+#    define HOT_PATH __attribute__((section(".time_critical.jobe")))
+#else
+#    define HOT_PATH
+#endif // MCU_RP && !HOT_PATH_DISABLE
+
+typedef struct {
+    uint32_t events;
+    uint32_t worst_cycles; // Slowest process_record_user, cache misses included.
+} hot_path_stats_t;
+
+extern hot_path_stats_t hot_path_stats;
+
+/** Record one event handled since `start`, a `timing_read_cycles` stamp. */
+void hot_path_measure(uint32_t start);
+
+/** Print the worst event latency, to compare builds with and without `HOT_PATH_DISABLE`. */
+void hot_path_report(void);
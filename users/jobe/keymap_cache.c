@@ -0,0 +1,120 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "keymap_cache.h"
+#include "dynamic_keymap.h"
+#include "via.h"
+#include "hot_path.h"
+#include "timing.h"
+#include "print.h"
+
+#define KEYMAP_CACHE_KEYS (DYNAMIC_KEYMAP_LAYER_COUNT * MATRIX_ROWS * MATRIX_COLS)
+
+typedef enum {
+    KEYMAP_CACHE_UNLOADED, // Not loaded yet, lookups go to the dynamic keymap.
+    KEYMAP_CACHE_STALE,
+    KEYMAP_CACHE_LOADED,
+} keymap_cache_state_t;
+
+static uint16_t             keymap_cache[DYNAMIC_KEYMAP_LAYER_COUNT][MATRIX_ROWS][MATRIX_COLS];
+static keymap_cache_state_t keymap_cache_state = KEYMAP_CACHE_UNLOADED;
+static uint32_t             keymap_cache_load_us;
+
+__attribute__((weak)) uint16_t keymap_cache_translate_user(uint8_t layer, keypos_t key, uint16_t keycode) {
+    return keycode;
+}
+
+static uint16_t keymap_cache_read(uint8_t layer, uint8_t row, uint8_t col) {
+    return keymap_cache_translate_user(layer, (keypos_t){.row = row, .col = col}, dynamic_keymap_get_keycode(layer, row, col));
+}
+
+void keymap_cache_load(void) {
+    uint32_t start = timing_read_us();
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                keymap_cache[layer][row][col] = keymap_cache_read(layer, row, col);
+            }
+        }
+    }
+    keymap_cache_state   = KEYMAP_CACHE_LOADED;
+    keymap_cache_load_us = timing_read_us() - start;
+}
+
+HOT_PATH uint16_t keymap_key_to_keycode(uint8_t layer, keypos_t key) {
+    if (layer >= DYNAMIC_KEYMAP_LAYER_COUNT || key.row >= MATRIX_ROWS || key.col >= MATRIX_COLS) {
+        return KC_NO;
+    }
+    if (keymap_cache_state == KEYMAP_CACHE_STALE) {
+        keymap_cache_load();
+    }
+    if (keymap_cache_state == KEYMAP_CACHE_UNLOADED) {
+        return keymap_cache_read(layer, key.row, key.col);
+    }
+    return keymap_cache[layer][key.row][key.col];
+}
+
+// Reload on the next lookup, once VIA has written the change
+static void keymap_cache_invalidate(void) {
+    if (keymap_cache_state != KEYMAP_CACHE_UNLOADED) {
+        keymap_cache_state = KEYMAP_CACHE_STALE;
+    }
+}
+
+bool via_command_kb(uint8_t *data, uint8_t length) {
+    switch (data[0]) {
+        case id_dynamic_keymap_set_keycode:
+            if (keymap_cache_state == KEYMAP_CACHE_LOADED && data[1] < DYNAMIC_KEYMAP_LAYER_COUNT && data[2] < MATRIX_ROWS && data[3] < MATRIX_COLS) {
+                keypos_t key                          = {.row = data[2], .col = data[3]};
+                keymap_cache[data[1]][data[2]][data[3]] = keymap_cache_translate_user(data[1], key, (data[4] << 8) | data[5]);
+            }
+            break;
+        case id_dynamic_keymap_set_buffer:
+        case id_dynamic_keymap_reset:
+        case id_eeprom_reset:
+            keymap_cache_invalidate();
+            break;
+    }
+    return false; // Let VIA handle the command
+}
+
+void keymap_cache_report(void) {
+    volatile uint16_t sink = 0;
+
+    uint32_t start = timing_read_cycles();
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                sink = keymap_key_to_keycode(layer, (keypos_t){.row = row, .col = col});
+            }
+        }
+    }
+    uint32_t cached = timing_cycles_since(start);
+
+    start = timing_read_cycles();
+    for (uint8_t layer = 0; layer < DYNAMIC_KEYMAP_LAYER_COUNT; layer++) {
+        for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+            for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+                sink = dynamic_keymap_get_keycode(layer, row, col);
+            }
+        }
+    }
+    uint32_t eeprom = timing_cycles_since(start);
+    (void)sink;
+
+    uprintf("keymap: %u keys, %lu cycles/lookup from RAM, %lu from the dynamic keymap\n", KEYMAP_CACHE_KEYS, (unsigned long)(cached / KEYMAP_CACHE_KEYS), (unsigned long)(eeprom / KEYMAP_CACHE_KEYS));
+    uprintf("keymap: %u bytes of RAM, loaded in %lu us\n", (unsigned)sizeof(keymap_cache), (unsigned long)keymap_cache_load_us);
+}
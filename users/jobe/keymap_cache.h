@@ -0,0 +1,59 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+/**
+ * \brief RAM copy of the VIA dynamic keymap.
+ *
+ * Every key event looks its keycode up in the dynamic keymap, which lives
+ * in EEPROM; on the RP2040 that is wear-levelled flash, searched on each
+ * read.  This keeps all `DYNAMIC_KEYMAP_LAYER_COUNT` layers in RAM instead,
+ * loaded once and updated as VIA writes keys: `via_command_kb` sees each
+ * command before VIA applies it, so single keys are copied in, and buffer
+ * writes and resets reload the whole copy on the next lookup.
+ *
+ * The copy is dense, one keycode per key.  VIA and QMK address the dynamic
+ * keymap as full `MATRIX_ROWS` x `MATRIX_COLS` layers, so only this copy
+ * could be packed, and it is small: 7 layers of 40 keys take 560 bytes, of
+ * which a bitmap and pool per layer would save about 50.
+ *
+ * Enabled with `KEYMAP_CACHE_ENABLE = yes` in the keymap's rules.mk, next to
+ * `VIA_ENABLE = yes`.  It replaces `keymap_key_to_keycode`, so encoder maps
+ * are not supported.
+ */
+
+/**
+ * \brief Read the dynamic keymap into RAM.  Call from keyboard_post_init_user.
+ *
+ * Lookups read the dynamic keymap until the first load, so it can be left
+ * until after boot.  Call again whenever `keymap_cache_translate_user` would
+ * answer differently.
+ */
+void keymap_cache_load(void);
+
+/**
+ * \brief Keycode to cache for a key of the dynamic keymap.
+ *
+ * Lets the keymap swap keys for a runtime profile at no cost per lookup.
+ * The default returns `keycode` unchanged.
+ */
+uint16_t keymap_cache_translate_user(uint8_t layer, keypos_t key, uint16_t keycode);
+
+/** Time lookups from the RAM copy against the dynamic keymap, and print both with the copy's size and load time. */
+void keymap_cache_report(void);
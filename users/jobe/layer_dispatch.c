@@ -0,0 +1,52 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "layer_dispatch.h"
+#include "print.h"
+
+layer_dispatch_stats_t layer_dispatch_stats;
+
+static layer_state_t dispatch_state   = 0;
+static uint8_t       dispatch_highest = LAYER_DISPATCH_UNSET;
+
+bool layer_dispatch_begin(layer_state_t state, layer_transition_t *transition) {
+    // The very first call runs even for state 0, to set every effect up
+    if (state == dispatch_state && dispatch_highest != LAYER_DISPATCH_UNSET) {
+        layer_dispatch_stats.suppressed++;
+        return false;
+    }
+    transition->state   = state;
+    transition->highest = get_highest_layer(state);
+
+    dispatch_state   = state;
+    dispatch_highest = transition->highest;
+    layer_dispatch_stats.transitions++;
+    return true;
+}
+
+bool layer_dispatch_changed(uint8_t *memo, uint8_t input) {
+    if (*memo == input) {
+        layer_dispatch_stats.effects_skipped++;
+        return false;
+    }
+    *memo = input;
+    layer_dispatch_stats.effects_run++;
+    return true;
+}
+
+void layer_dispatch_report(void) {
+    uprintf("layers: %lu transitions, %lu no-op suppressed, effects %lu run %lu skipped\n", (unsigned long)layer_dispatch_stats.transitions, (unsigned long)layer_dispatch_stats.suppressed, (unsigned long)layer_dispatch_stats.effects_run, (unsigned long)layer_dispatch_stats.effects_skipped);
+}
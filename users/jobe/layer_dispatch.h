@@ -0,0 +1,58 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+/**
+ * \brief Run layer_state_set_user side effects only when their inputs change.
+ *
+ * `layer_dispatch_begin` drops calls that repeat the last dispatched state
+ * and computes the highest layer once for the rest.  Each side effect then
+ * keeps a memo of its own input, eg. "sniping layer active" or "highest
+ * layer", and `layer_dispatch_changed` tells whether it needs to run:
+ *
+ *     static uint8_t sniping = LAYER_DISPATCH_UNSET;
+ *     if (layer_dispatch_changed(&sniping, layer_state_cmp(state, LAYER_POINTER))) {
+ *         charybdis_set_pointer_sniping_enabled(sniping);
+ *     }
+ */
+
+#define LAYER_DISPATCH_UNSET 0xFF // Initial memo value, so the first dispatch always runs.
+
+typedef struct {
+    layer_state_t state;
+    uint8_t       highest;
+} layer_transition_t;
+
+typedef struct {
+    uint32_t transitions; // Dispatched state changes.
+    uint32_t suppressed;  // Calls repeating the last state.
+    uint32_t effects_run;
+    uint32_t effects_skipped; // Side effects whose input did not change.
+} layer_dispatch_stats_t;
+
+extern layer_dispatch_stats_t layer_dispatch_stats;
+
+/** Fill `transition`, or return false if `state` is the last dispatched one. */
+bool layer_dispatch_begin(layer_state_t state, layer_transition_t *transition);
+
+/** Store `input` in `memo` and return whether it differs from the stored value. */
+bool layer_dispatch_changed(uint8_t *memo, uint8_t input);
+
+/** Print the dispatch counters to the console. */
+void layer_dispatch_report(void);
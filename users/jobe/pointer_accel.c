@@ -0,0 +1,77 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pointer_accel.h"
+
+#ifdef MOUSE_EXTENDED_REPORT
+#    define POINTER_ACCEL_XY_MAX INT16_MAX
+#else
+#    define POINTER_ACCEL_XY_MAX INT8_MAX
+#endif // MOUSE_EXTENDED_REPORT
+
+#define POINTER_ACCEL_STEPS 32
+
+// Q8 gain per speed step; smoothstep between the two ends over 24 steps.
+// clang-format off
+static const uint16_t PROGMEM pointer_accel_curves[POINTER_ACCEL_CURVE_COUNT][POINTER_ACCEL_STEPS] = {
+    [POINTER_ACCEL_DEFAULT] = {
+        192, 194, 201, 211, 225, 242, 262, 284, 308, 334, 361, 388, 416, 444, 471, 498,
+        524, 548, 570, 590, 607, 621, 631, 638, 640, 640, 640, 640, 640, 640, 640, 640,
+    },
+    [POINTER_ACCEL_PRECISE] = {
+        128, 129, 131, 134, 137, 142, 148, 154, 161, 168, 176, 184, 192, 200, 208, 216,
+        223, 230, 236, 242, 247, 250, 253, 255, 256, 256, 256, 256, 256, 256, 256, 256,
+    },
+    [POINTER_ACCEL_LINEAR] = {
+        [0 ... POINTER_ACCEL_STEPS - 1] = 256,
+    },
+};
+// clang-format on
+
+// Sub-count remainder of the last report, Q8.
+static int16_t pointer_accel_carry_x = 0;
+static int16_t pointer_accel_carry_y = 0;
+
+static mouse_xy_report_t pointer_accel_scale(mouse_xy_report_t delta, uint16_t gain, int16_t *carry) {
+    int32_t scaled = (int32_t)delta * gain + *carry;
+    int32_t counts = scaled >> 8; // Floors, so the carry is always 0..255.
+    *carry         = scaled - (counts << 8);
+
+    if (counts > POINTER_ACCEL_XY_MAX) {
+        return POINTER_ACCEL_XY_MAX;
+    }
+    if (counts < -POINTER_ACCEL_XY_MAX) {
+        return -POINTER_ACCEL_XY_MAX;
+    }
+    return counts;
+}
+
+void pointer_accel_task(report_mouse_t *mouse_report, pointer_accel_curve_t curve) {
+    if (curve >= POINTER_ACCEL_CURVE_COUNT) {
+        return;
+    }
+
+    uint16_t ax    = abs(mouse_report->x);
+    uint16_t ay    = abs(mouse_report->y);
+    uint16_t speed = (ax > ay ? ax + (ay >> 1) : ay + (ax >> 1)) >> POINTER_ACCEL_SPEED_SHIFT;
+    if (speed >= POINTER_ACCEL_STEPS) {
+        speed = POINTER_ACCEL_STEPS - 1;
+    }
+    uint16_t gain = pgm_read_word(&pointer_accel_curves[curve][speed]);
+
+    mouse_report->x = pointer_accel_scale(mouse_report->x, gain, &pointer_accel_carry_x);
+    mouse_report->y = pointer_accel_scale(mouse_report->y, gain, &pointer_accel_carry_y);
+}
@@ -0,0 +1,42 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+/**
+ * \brief Pointer acceleration for the trackball keymaps.
+ *
+ * The speed of each report (max + min / 2 of |x| and |y|, shifted right by
+ * `POINTER_ACCEL_SPEED_SHIFT`) indexes a 32-entry curve of Q8 gains.  The
+ * fractional part of every scaled delta is carried into the next report, so
+ * gains below 1 slow the pointer down without dropping counts.
+ */
+
+#ifndef POINTER_ACCEL_SPEED_SHIFT
+#    define POINTER_ACCEL_SPEED_SHIFT 0
+#endif // POINTER_ACCEL_SPEED_SHIFT
+
+typedef enum {
+    POINTER_ACCEL_DEFAULT, // 0.75x when crawling up to 2.5x on flicks.
+    POINTER_ACCEL_PRECISE, // 0.5x when crawling up to 1x.
+    POINTER_ACCEL_LINEAR,  // Sensor counts as-is.
+    POINTER_ACCEL_CURVE_COUNT,
+} pointer_accel_curve_t;
+
+/** Scale the report's x/y along `curve`. */
+void pointer_accel_task(report_mouse_t *mouse_report, pointer_accel_curve_t curve);
@@ -0,0 +1,106 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pointer_batch.h"
+#include "print.h"
+#include "timing.h"
+
+#ifdef MOUSE_EXTENDED_REPORT
+#    define POINTER_BATCH_XY_MAX INT16_MAX
+#else
+#    define POINTER_BATCH_XY_MAX INT8_MAX
+#endif // MOUSE_EXTENDED_REPORT
+
+#ifdef WHEEL_EXTENDED_REPORT
+#    define POINTER_BATCH_HV_MAX INT16_MAX
+#else
+#    define POINTER_BATCH_HV_MAX INT8_MAX
+#endif // WHEEL_EXTENDED_REPORT
+
+// Longer gaps mean the ball stopped, not a late report.
+#define POINTER_BATCH_GAP_US (POINTER_BATCH_INTERVAL_US * 4)
+
+pointer_batch_stats_t pointer_batch_stats = {.interval_min_us = UINT32_MAX};
+
+static int32_t  batch_x, batch_y, batch_h, batch_v;
+static uint16_t batch_samples = 0;
+static uint8_t  batch_buttons = 0;
+static uint32_t batch_sent_us = 0;
+
+static int32_t batch_take(int32_t *sum, int32_t max) {
+    int32_t out = *sum > max ? max : *sum < -max ? -max : *sum;
+    *sum -= out; // Anything over the report range goes out next time.
+    return out;
+}
+
+static void batch_count_report(uint32_t now) {
+    pointer_batch_stats_t *stats = &pointer_batch_stats;
+    uint32_t               gap   = now - batch_sent_us;
+
+    stats->reports++;
+    stats->samples += batch_samples;
+    if (gap < POINTER_BATCH_GAP_US) {
+        if (gap < stats->interval_min_us) {
+            stats->interval_min_us = gap;
+        }
+        if (gap > stats->interval_max_us) {
+            stats->interval_max_us = gap;
+        }
+        stats->interval_sum_us += gap;
+        stats->jitter_sum_us += gap > POINTER_BATCH_INTERVAL_US ? gap - POINTER_BATCH_INTERVAL_US : POINTER_BATCH_INTERVAL_US - gap;
+        stats->intervals++;
+    }
+}
+
+void pointer_batch_task(report_mouse_t *mouse_report) {
+    batch_x += mouse_report->x;
+    batch_y += mouse_report->y;
+    batch_h += mouse_report->h;
+    batch_v += mouse_report->v;
+    batch_samples++;
+
+    bool     moving = batch_x || batch_y || batch_h || batch_v;
+    uint32_t now    = timing_read_us();
+    if (mouse_report->buttons == batch_buttons && (!moving || now - batch_sent_us < POINTER_BATCH_INTERVAL_US)) {
+        // Nothing QMK would send: zero motion with unchanged buttons
+        mouse_report->x = mouse_report->y = mouse_report->h = mouse_report->v = 0;
+        if (!moving) {
+            batch_samples = 0;
+        }
+        return;
+    }
+
+    mouse_report->x = batch_take(&batch_x, POINTER_BATCH_XY_MAX);
+    mouse_report->y = batch_take(&batch_y, POINTER_BATCH_XY_MAX);
+    mouse_report->h = batch_take(&batch_h, POINTER_BATCH_HV_MAX);
+    mouse_report->v = batch_take(&batch_v, POINTER_BATCH_HV_MAX);
+    if (moving) {
+        batch_count_report(now);
+    }
+    batch_buttons = mouse_report->buttons;
+    batch_samples = 0;
+    batch_sent_us = now;
+}
+
+void pointer_batch_report(void) {
+    pointer_batch_stats_t *stats     = &pointer_batch_stats;
+    uint32_t               intervals = stats->intervals ? stats->intervals : 1;
+    uint32_t               reports   = stats->reports ? stats->reports : 1;
+
+    // Samples per report in tenths
+    uprintf("pointer: %lu reports, %lu.%lu samples/report\n", (unsigned long)stats->reports, (unsigned long)(stats->samples / reports), (unsigned long)(stats->samples * 10 / reports % 10));
+    uprintf("pointer: interval %lu/%lu/%lu us min/mean/max, jitter %lu us\n", (unsigned long)(stats->intervals ? stats->interval_min_us : 0), (unsigned long)(stats->interval_sum_us / intervals), (unsigned long)stats->interval_max_us, (unsigned long)(stats->jitter_sum_us / intervals));
+}
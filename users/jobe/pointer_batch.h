@@ -0,0 +1,54 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+/**
+ * \brief Pointer reports at the USB poll rate, whatever the main loop does.
+ *
+ * The sensor is read at the fixed `POINTING_DEVICE_TASK_THROTTLE_MS` rate.
+ * Each read's deltas are summed here, and the sum goes out once per
+ * `POINTER_BATCH_INTERVAL_US`.  Button changes flush right away.  A fast
+ * loop no longer sends near-empty reports, and a slow one loses no motion.
+ */
+
+#ifndef POINTER_BATCH_INTERVAL_US
+#    ifdef USB_POLLING_INTERVAL_MS
+#        define POINTER_BATCH_INTERVAL_US (USB_POLLING_INTERVAL_MS * 1000)
+#    else
+#        define POINTER_BATCH_INTERVAL_US 1000
+#    endif // USB_POLLING_INTERVAL_MS
+#endif // POINTER_BATCH_INTERVAL_US
+
+typedef struct {
+    uint32_t reports;
+    uint32_t samples;         // Sensor reads folded into those reports.
+    uint32_t interval_min_us; // Between back-to-back reports while moving.
+    uint32_t interval_max_us;
+    uint32_t interval_sum_us;
+    uint32_t jitter_sum_us; // |interval - POINTER_BATCH_INTERVAL_US|, summed.
+    uint32_t intervals;
+} pointer_batch_stats_t;
+
+extern pointer_batch_stats_t pointer_batch_stats;
+
+/** Fold one sensor read into the batch.  Call last in pointing_device_task_user. */
+void pointer_batch_task(report_mouse_t *mouse_report);
+
+/** Print samples per report and the report interval jitter to the console. */
+void pointer_batch_report(void);
@@ -0,0 +1,179 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pointer_replay.h"
+#include "print.h"
+#include "timing.h"
+
+// Built-in stream: a slow crawl, a flick ramping up and down, then rest so
+// timeouts and momentum play out.
+#define REPLAY_CRAWL_END 300
+#define REPLAY_FLICK_END 500
+#define REPLAY_REST_END  1500
+
+typedef enum {
+    REPLAY_IDLE,
+    REPLAY_RECORDING,
+    REPLAY_PLAYING,
+    REPLAY_PRINTING,
+} replay_state_t;
+
+typedef struct {
+    int8_t x;
+    int8_t y;
+} replay_sample_t;
+
+// What came out of the pipeline for one sample.
+typedef struct {
+    mouse_xy_report_t x;
+    mouse_xy_report_t y;
+    mouse_hv_report_t h;
+    mouse_hv_report_t v;
+    uint8_t           layer;
+    uint16_t          cycles; // Saturates, a read that slow stands out anyway.
+} replay_result_t;
+
+static replay_sample_t replay_samples[POINTER_REPLAY_SAMPLES];
+static replay_result_t replay_results[POINTER_REPLAY_SAMPLES];
+static uint16_t        replay_length     = 0; // Samples of the last kept recording.
+static uint16_t        replay_recorded   = 0; // Samples of the recording in progress.
+static uint16_t        replay_index      = 0; // Sample being played, then printed.
+static replay_state_t  replay_state      = REPLAY_IDLE;
+static uint16_t        replay_timer      = 0;
+static uint8_t         replay_layer      = 0; // Layer at the start, then as of the last printed line.
+static uint32_t        replay_cycles_max = 0;
+static uint32_t        replay_cycles_sum = 0;
+
+static int8_t replay_clamp(int16_t value) {
+    return value > INT8_MAX ? INT8_MAX : value < -INT8_MAX ? -INT8_MAX : value;
+}
+
+static replay_sample_t replay_synthetic(uint16_t i) {
+    if (i < REPLAY_CRAWL_END) {
+        return (replay_sample_t){.x = (i & 3) == 0, .y = 0};
+    }
+    if (i < REPLAY_FLICK_END) {
+        // Triangle up to 40 counts per read
+        uint16_t t     = i - REPLAY_CRAWL_END;
+        uint16_t half  = (REPLAY_FLICK_END - REPLAY_CRAWL_END) / 2;
+        int8_t   speed = (t < half ? t : 2 * half - t) * 40 / half;
+        return (replay_sample_t){.x = speed, .y = -speed / 2};
+    }
+    return (replay_sample_t){0, 0};
+}
+
+static replay_sample_t replay_sample(uint16_t i) {
+    return replay_length ? replay_samples[i] : replay_synthetic(i);
+}
+
+static uint16_t replay_total(void) {
+    return replay_length ? replay_length : REPLAY_REST_END < POINTER_REPLAY_SAMPLES ? REPLAY_REST_END : POINTER_REPLAY_SAMPLES;
+}
+
+void pointer_replay_key(keyrecord_t *record) {
+    if (record->event.pressed) {
+        replay_state    = REPLAY_RECORDING;
+        replay_timer    = timer_read();
+        replay_recorded = 0;
+        return;
+    }
+    // A tap keeps the previous recording, or the built-in stream if there is none
+    if (timer_elapsed(replay_timer) >= TAPPING_TERM) {
+        replay_length = replay_recorded;
+    }
+    replay_state      = REPLAY_PLAYING;
+    replay_index      = 0;
+    replay_layer      = get_highest_layer(layer_state);
+    replay_cycles_max = 0;
+    replay_cycles_sum = 0;
+    uprintf("replay: start, %u samples%s\n", replay_total(), replay_length ? "" : " (built-in)");
+}
+
+uint32_t pointer_replay_input(report_mouse_t *mouse_report) {
+    switch (replay_state) {
+        case REPLAY_RECORDING:
+            // Only once it is a hold, so a tap leaves the last recording alone
+            if (timer_elapsed(replay_timer) >= TAPPING_TERM && replay_recorded < POINTER_REPLAY_SAMPLES) {
+                replay_samples[replay_recorded++] = (replay_sample_t){replay_clamp(mouse_report->x), replay_clamp(mouse_report->y)};
+            }
+            break;
+        case REPLAY_PLAYING: {
+            replay_sample_t in = replay_sample(replay_index);
+            mouse_report->x    = in.x;
+            mouse_report->y    = in.y;
+            break;
+        }
+        default:
+            break;
+    }
+    return timing_read_cycles();
+}
+
+// Print the next line that has something in it; false once all are out.
+static bool replay_print_next(void) {
+    uint16_t length = replay_total();
+    for (; replay_index < length; replay_index++) {
+        const replay_result_t *out = &replay_results[replay_index];
+        replay_sample_t        in  = replay_sample(replay_index);
+
+        if (out->layer != replay_layer) {
+            uprintf("replay: layer %u -> %u at %u\n", replay_layer, out->layer, replay_index);
+            replay_layer = out->layer;
+        }
+        if (in.x || in.y || out->x || out->y || out->h || out->v) {
+            uprintf("replay,%u,%d,%d,%d,%d,%d,%d,%u,%u\n", replay_index, in.x, in.y, out->x, out->y, out->h, out->v, out->layer, out->cycles);
+            replay_index++;
+            return true;
+        }
+    }
+    uprintf("replay: done, cycles mean %lu max %lu\n", (unsigned long)(replay_cycles_sum / length), (unsigned long)replay_cycles_max);
+    return false;
+}
+
+void pointer_replay_output(const report_mouse_t *mouse_report, uint32_t start) {
+    if (replay_state == REPLAY_PRINTING) {
+        for (uint8_t line = 0; line < POINTER_REPLAY_PRINT_LINES; line++) {
+            if (!replay_print_next()) {
+                replay_state = REPLAY_IDLE;
+                break;
+            }
+        }
+        return;
+    }
+    if (replay_state != REPLAY_PLAYING) {
+        return;
+    }
+
+    uint32_t cycles = timing_cycles_since(start);
+    if (cycles > replay_cycles_max) {
+        replay_cycles_max = cycles;
+    }
+    replay_cycles_sum += cycles;
+
+    replay_results[replay_index] = (replay_result_t){
+        .x      = mouse_report->x,
+        .y      = mouse_report->y,
+        .h      = mouse_report->h,
+        .v      = mouse_report->v,
+        .layer  = get_highest_layer(layer_state),
+        .cycles = cycles > UINT16_MAX ? UINT16_MAX : cycles,
+    };
+
+    if (++replay_index >= replay_total()) {
+        replay_state = REPLAY_PRINTING;
+        replay_index = 0;
+    }
+}
@@ -0,0 +1,58 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+
+/**
+ * \brief Replay recorded or synthetic ball motion through the pointer pipeline.
+ *
+ * Holding the replay key past the tapping term records raw sensor reads,
+ * up to `POINTER_REPLAY_SAMPLES` of them.  Tapping it feeds the recording back in
+ * place of the sensor, one sample per read.  With nothing recorded, a
+ * built-in crawl, flick and rest stream is fed instead.  What comes out of
+ * each read is kept in RAM, and once the replay is over every report that
+ * moves goes to the console as
+ *
+ *     replay,<sample>,<in x>,<in y>,<x>,<y>,<h>,<v>,<layer>,<cycles>
+ *
+ * `POINTER_REPLAY_PRINT_LINES` lines per read, so printing neither slows the
+ * replay down nor overruns the console.  Changes to acceleration, scrolling
+ * or the auto pointer layer can then be compared run against run, without
+ * touching the ball.
+ */
+
+#ifndef POINTER_REPLAY_SAMPLES
+#    define POINTER_REPLAY_SAMPLES 2048 // One per sensor read, ~2 s at 1 ms; 10 bytes of RAM each.
+#endif // POINTER_REPLAY_SAMPLES
+
+#ifndef POINTER_REPLAY_PRINT_LINES
+#    define POINTER_REPLAY_PRINT_LINES 1
+#endif // POINTER_REPLAY_PRINT_LINES
+
+/** Record while held, replay on release.  Call from process_record_user. */
+void pointer_replay_key(keyrecord_t *record);
+
+/**
+ * \brief Record or substitute the sensor read.  Call first in pointing_device_task_user.
+ *
+ * Returns the cycle timestamp to pass to `pointer_replay_output`.
+ */
+uint32_t pointer_replay_input(report_mouse_t *mouse_report);
+
+/** Keep the transformed report while replaying, print them after.  Call last in pointing_device_task_user. */
+void pointer_replay_output(const report_mouse_t *mouse_report, uint32_t start);
@@ -0,0 +1,115 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "profiler.h"
+#include "hot_path.h"
+#include "print.h"
+
+typedef struct {
+    uint32_t calls;
+    uint32_t min;
+    uint32_t max;
+    uint64_t sum;
+    uint16_t buckets[PROFILER_BUCKETS]; // Calls of [2^(i-1), 2^i) cycles, saturating.
+} profiler_stats_t;
+
+static const char *const profiler_names[PROFILE_RGB_EFFECT] = {
+    [PROFILE_PROCESS_RECORD] = "process_record_user",
+    [PROFILE_SMTD]           = "process_smtd",
+    [PROFILE_HOUSEKEEPING]   = "housekeeping_task_user",
+    [PROFILE_POINTING]       = "pointing_device_task_user",
+    [PROFILE_LAYER_STATE]    = "layer_state_set_user",
+};
+
+#if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_CUSTOM_USER)
+// The effect list, without the implementations
+static const char *const profiler_effect_names[] = {
+#    define RGB_MATRIX_EFFECT(name) #name,
+#    include "rgb_matrix_user.inc"
+#    undef RGB_MATRIX_EFFECT
+};
+#    define PROFILER_EFFECTS ARRAY_SIZE(profiler_effect_names)
+#else
+#    define PROFILER_EFFECTS 0
+#endif // RGB_MATRIX_ENABLE && RGB_MATRIX_CUSTOM_USER
+
+static profiler_stats_t profiler_stats[PROFILE_RGB_EFFECT + PROFILER_EFFECTS];
+
+// floor(log2(cycles)) + 1, without CLZ on the M0+
+static HOT_PATH uint8_t profiler_bucket(uint32_t cycles) {
+    uint8_t bucket = 0;
+    for (uint8_t shift = 16; shift; shift >>= 1) {
+        if (cycles >> shift) {
+            cycles >>= shift;
+            bucket += shift;
+        }
+    }
+    bucket += cycles;
+    return bucket < PROFILER_BUCKETS ? bucket : PROFILER_BUCKETS - 1;
+}
+
+HOT_PATH void profiler_record(uint8_t slot, uint32_t cycles) {
+    profiler_stats_t *stats = &profiler_stats[slot];
+    if (stats->calls == 0 || cycles < stats->min) {
+        stats->min = cycles;
+    }
+    if (cycles > stats->max) {
+        stats->max = cycles;
+    }
+    stats->calls++;
+    stats->sum += cycles;
+
+    uint16_t *bucket = &stats->buckets[profiler_bucket(cycles)];
+    if (*bucket < UINT16_MAX) {
+        (*bucket)++;
+    }
+}
+
+HOT_PATH void profiler_record_effect(uint8_t mode, uint32_t cycles) {
+#if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_CUSTOM_USER)
+    // User effects are the last modes
+    uint8_t first = RGB_MATRIX_EFFECT_MAX - PROFILER_EFFECTS;
+    if (mode >= first && mode < RGB_MATRIX_EFFECT_MAX) {
+        profiler_record(PROFILE_RGB_EFFECT + mode - first, cycles);
+    }
+#endif // RGB_MATRIX_ENABLE && RGB_MATRIX_CUSTOM_USER
+}
+
+void profiler_report(void) {
+    for (uint8_t slot = 0; slot < ARRAY_SIZE(profiler_stats); slot++) {
+        profiler_stats_t *stats = &profiler_stats[slot];
+        if (stats->calls == 0) {
+            continue;
+        }
+#if defined(RGB_MATRIX_ENABLE) && defined(RGB_MATRIX_CUSTOM_USER)
+        const char *name = slot < PROFILE_RGB_EFFECT ? profiler_names[slot] : profiler_effect_names[slot - PROFILE_RGB_EFFECT];
+#else
+        const char *name = profiler_names[slot];
+#endif // RGB_MATRIX_ENABLE && RGB_MATRIX_CUSTOM_USER
+        uprintf("profile %s: %lu calls, cycles min %lu mean %lu max %lu\n", name, (unsigned long)stats->calls, (unsigned long)stats->min, (unsigned long)(stats->sum / stats->calls), (unsigned long)stats->max);
+        for (uint8_t i = 0; i < PROFILER_BUCKETS; i++) {
+            if (stats->buckets[i] == 0) {
+                continue;
+            }
+            if (i < PROFILER_BUCKETS - 1) {
+                uprintf("  < 2^%u: %u\n", i, stats->buckets[i]);
+            } else {
+                uprintf("  >= 2^%u: %u\n", i - 1, stats->buckets[i]);
+            }
+        }
+    }
+    memset(profiler_stats, 0, sizeof(profiler_stats));
+}
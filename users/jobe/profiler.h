@@ -0,0 +1,65 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include QMK_KEYBOARD_H
+#include "timing.h"
+
+/**
+ * \brief Cycle counts of the userspace callbacks.
+ *
+ * Each profiled callback keeps its call count, min, mean and max cycles,
+ * and a histogram with one bucket per power of two.  Custom RGB effects are
+ * profiled per effect, through `RGB_KERNEL_BENCH_BEGIN`/`END`.
+ *
+ * Enabled with `PROFILER_ENABLE = yes` in the keymap's rules.mk; otherwise
+ * `PROFILE_BEGIN`/`PROFILE_END` expand to nothing.  Wrap a callback as:
+ *
+ *     PROFILE_BEGIN(PROFILE_POINTING);
+ *     ...
+ *     PROFILE_END(PROFILE_POINTING);
+ */
+
+#ifndef PROFILER_BUCKETS
+#    define PROFILER_BUCKETS 20 // Bucket i counts calls under 2^i cycles; the last one has the rest.
+#endif // PROFILER_BUCKETS
+
+typedef enum {
+    PROFILE_PROCESS_RECORD,
+    PROFILE_SMTD,
+    PROFILE_HOUSEKEEPING,
+    PROFILE_POINTING,
+    PROFILE_LAYER_STATE,
+    PROFILE_RGB_EFFECT, // Followed by one slot per effect of rgb_matrix_user.inc.
+} profile_slot_t;
+
+#ifdef PROFILER_ENABLE
+#    define PROFILE_BEGIN(slot) uint32_t profile_start_##slot = timing_read_cycles()
+#    define PROFILE_END(slot)   profiler_record(slot, timing_cycles_since(profile_start_##slot))
+#else
+#    define PROFILE_BEGIN(slot)
+#    define PROFILE_END(slot)
+#endif // PROFILER_ENABLE
+
+/** Add a call of `cycles` to `slot`. */
+void profiler_record(uint8_t slot, uint32_t cycles);
+
+/** Add a call of `cycles` to the slot of RGB matrix `mode`, if it is a custom effect. */
+void profiler_record_effect(uint8_t mode, uint32_t cycles);
+
+/** Print the stats of every slot called since the last report, and reset them. */
+void profiler_report(void);
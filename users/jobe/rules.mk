@@ -0,0 +1,33 @@
+SRC += timing.c
+SRC += layer_dispatch.c
+SRC += hot_path.c
+
+ifeq ($(strip $(BOOT_TRACE_ENABLE)), yes)
+    OPT_DEFS += -DBOOT_TRACE_ENABLE
+    SRC += boot_trace.c
+endif
+
+ifeq ($(strip $(PROFILER_ENABLE)), yes)
+    OPT_DEFS += -DPROFILER_ENABLE
+    SRC += profiler.c
+endif
+
+ifeq ($(strip $(KEYMAP_CACHE_ENABLE)), yes)
+    OPT_DEFS += -DKEYMAP_CACHE_ENABLE
+    SRC += keymap_cache.c
+endif
+
+ifeq ($(strip $(DEBOUNCE_TYPE)), custom)
+    OPT_DEFS += -DASYM_DEBOUNCE_ENABLE
+    SRC += asym_debounce.c
+endif
+
+ifeq ($(strip $(POINTING_DEVICE_ENABLE)), yes)
+    DEFERRED_EXEC_ENABLE = yes
+    SRC += auto_pointer.c
+    SRC += pointer_accel.c
+    SRC += drag_scroll.c
+    SRC += pointer_batch.c
+    SRC += pointer_replay.c
+    SRC += flick_gesture.c
+endif
@@ -0,0 +1,50 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdio.h>
+
+/**
+ * \brief Console for the host tests.
+ *
+ * Goes to stdout, or into `fake_console` while `fake_console_capture` is
+ * set, for tests that compare what a report printed.
+ */
+
+static char   fake_console[1 << 17];
+static size_t fake_console_length  = 0;
+static bool   fake_console_capture = false;
+
+static inline __attribute__((format(printf, 1, 2))) void fake_console_printf(const char *format, ...) {
+    va_list args;
+    va_start(args, format);
+    if (fake_console_capture) {
+        size_t room = sizeof(fake_console) - fake_console_length;
+        int    length = vsnprintf(fake_console + fake_console_length, room, format, args);
+        if (length > 0) {
+            fake_console_length += (size_t)length < room ? (size_t)length : room - 1;
+        }
+    } else {
+        vprintf(format, args);
+    }
+    va_end(args);
+}
+
+#define uprintf fake_console_printf
+#define dprintf fake_console_printf
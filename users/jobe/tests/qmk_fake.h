@@ -0,0 +1,251 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+/**
+ * \brief Stand-in for QMK_KEYBOARD_H on the host.
+ *
+ * Only the types and calls the tested sources use, with a clock the tests
+ * move by hand.  Not a model of QMK beyond that.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "timer.h"
+
+#define PROGMEM
+#define pgm_read_byte(address) (*(const uint8_t *)(address))
+#define pgm_read_word(address) (*(const uint16_t *)(address))
+#define memcpy_P(dest, src, n)  memcpy((dest), (src), (n))
+
+#ifndef ARRAY_SIZE
+#    define ARRAY_SIZE(array) (sizeof(array) / sizeof((array)[0]))
+#endif // ARRAY_SIZE
+
+// Charybdis 3x5: two halves of four rows
+#ifndef MATRIX_ROWS
+#    define MATRIX_ROWS 8
+#endif // MATRIX_ROWS
+#ifndef MATRIX_COLS
+#    define MATRIX_COLS 5
+#endif // MATRIX_COLS
+
+#if MATRIX_COLS <= 8
+typedef uint8_t matrix_row_t;
+#elif MATRIX_COLS <= 16
+typedef uint16_t matrix_row_t;
+#else
+typedef uint32_t matrix_row_t;
+#endif // MATRIX_COLS
+
+// GPIO and waits: pins are plain numbers, and only the matrix tests use
+// them, through the port macros they define.
+typedef uint32_t pin_t;
+
+static bool __attribute__((unused)) debug_matrix = false;
+
+static inline void gpio_set_pin_input_high(pin_t pin) {}
+static inline void gpio_write_pin_low(pin_t pin) {}
+static inline void wait_cpuclock(uint32_t cycles) {}
+
+#ifndef CPU_CLOCK
+#    define CPU_CLOCK 125000000
+#endif // CPU_CLOCK
+
+// Keys and layers
+typedef struct {
+    uint8_t col;
+    uint8_t row;
+} keypos_t;
+
+typedef struct {
+    keypos_t key;
+    bool     pressed;
+    uint16_t time;
+} keyevent_t;
+
+typedef struct {
+    keyevent_t event;
+} keyrecord_t;
+
+typedef uint32_t layer_state_t;
+
+static layer_state_t __attribute__((unused)) layer_state = 0;
+
+static inline uint8_t get_highest_layer(layer_state_t state) {
+    return state ? 31 - __builtin_clz(state) : 0;
+}
+
+static inline void layer_on(uint8_t layer) {
+    layer_state |= (layer_state_t)1 << layer;
+}
+
+static inline void layer_off(uint8_t layer) {
+    layer_state &= ~((layer_state_t)1 << layer);
+}
+
+// Deferred callbacks, run by fake_deferred_run as the test moves the clock
+typedef uint8_t deferred_token;
+typedef uint32_t (*deferred_exec_callback)(uint32_t trigger_time, void *cb_arg);
+
+#define INVALID_DEFERRED_TOKEN 0
+#define FAKE_DEFERRED_MAX      8
+
+typedef struct {
+    deferred_exec_callback callback;
+    void                  *cb_arg;
+    uint32_t               trigger_time;
+} fake_deferred_t;
+
+static fake_deferred_t __attribute__((unused)) fake_deferred[FAKE_DEFERRED_MAX];
+
+static inline deferred_token defer_exec(uint32_t delay_ms, deferred_exec_callback callback, void *cb_arg) {
+    for (uint8_t i = 0; i < FAKE_DEFERRED_MAX; i++) {
+        if (!fake_deferred[i].callback) {
+            fake_deferred[i] = (fake_deferred_t){callback, cb_arg, timer_read32() + delay_ms};
+            return i + 1;
+        }
+    }
+    return INVALID_DEFERRED_TOKEN;
+}
+
+static inline bool cancel_deferred_exec(deferred_token token) {
+    if (token == INVALID_DEFERRED_TOKEN || !fake_deferred[token - 1].callback) {
+        return false;
+    }
+    fake_deferred[token - 1].callback = NULL;
+    return true;
+}
+
+static inline void fake_deferred_run(void) {
+    uint32_t now = timer_read32();
+    for (uint8_t i = 0; i < FAKE_DEFERRED_MAX; i++) {
+        fake_deferred_t *entry = &fake_deferred[i];
+        if (entry->callback && (int32_t)(now - entry->trigger_time) >= 0) {
+            uint32_t delay = entry->callback(entry->trigger_time, entry->cb_arg);
+            if (delay) {
+                entry->trigger_time += delay;
+            } else {
+                entry->callback = NULL;
+            }
+        }
+    }
+}
+
+// Pointing device
+#ifdef MOUSE_EXTENDED_REPORT
+typedef int16_t mouse_xy_report_t;
+#else
+typedef int8_t mouse_xy_report_t;
+#endif // MOUSE_EXTENDED_REPORT
+
+#ifdef WHEEL_EXTENDED_REPORT
+typedef int16_t mouse_hv_report_t;
+#else
+typedef int8_t mouse_hv_report_t;
+#endif // WHEEL_EXTENDED_REPORT
+
+typedef struct {
+    uint8_t           buttons;
+    mouse_xy_report_t x;
+    mouse_xy_report_t y;
+    mouse_hv_report_t v;
+    mouse_hv_report_t h;
+} report_mouse_t;
+
+// RGB matrix: the Charybdis 3x5x3's 36 LEDs, 18 a half.  Colours set by
+// effects land in fake_leds.
+#ifndef RGB_MATRIX_LED_COUNT
+#    define RGB_MATRIX_LED_COUNT 36
+#endif // RGB_MATRIX_LED_COUNT
+#ifndef RGB_MATRIX_MAXIMUM_BRIGHTNESS
+#    define RGB_MATRIX_MAXIMUM_BRIGHTNESS 150
+#endif // RGB_MATRIX_MAXIMUM_BRIGHTNESS
+
+typedef struct {
+    uint8_t r;
+    uint8_t g;
+    uint8_t b;
+} rgb_t;
+
+typedef struct {
+    uint8_t h;
+    uint8_t s;
+    uint8_t v;
+} hsv_t;
+
+typedef uint8_t led_flags_t;
+
+typedef struct {
+    uint8_t     iter;
+    led_flags_t flags;
+    bool        init;
+} effect_params_t;
+
+#define NO_LED 255
+
+#define LED_FLAG_KEYLIGHT 0x04
+#define LED_FLAG_ALL      0xFF
+
+#define HAS_ANY_FLAGS(bits, flags) (((bits) & (flags)) != 0x00)
+
+typedef struct {
+    uint8_t     matrix_co[MATRIX_ROWS][MATRIX_COLS];
+    led_flags_t flags[RGB_MATRIX_LED_COUNT];
+} led_config_t;
+
+extern led_config_t g_led_config; // The test's wiring.
+
+typedef struct {
+    uint8_t enable;
+    uint8_t mode;
+    hsv_t   hsv;
+    uint8_t speed;
+    uint8_t flags;
+} rgb_config_t;
+
+static rgb_config_t __attribute__((unused)) rgb_matrix_config = {.enable = 1, .hsv = {0, 255, RGB_MATRIX_MAXIMUM_BRIGHTNESS}};
+
+static inline uint8_t rgb_matrix_get_mode(void) {
+    return rgb_matrix_config.mode;
+}
+
+// One board, no split: effects render every LED, a process limit at a time
+#ifndef RGB_MATRIX_LED_PROCESS_LIMIT
+#    define RGB_MATRIX_LED_PROCESS_LIMIT ((RGB_MATRIX_LED_COUNT + 4) / 5)
+#endif // RGB_MATRIX_LED_PROCESS_LIMIT
+
+#define RGB_MATRIX_USE_LIMITS(min, max)                               \
+    uint8_t min = RGB_MATRIX_LED_PROCESS_LIMIT * params->iter;         \
+    uint8_t max = min + RGB_MATRIX_LED_PROCESS_LIMIT;                  \
+    if (max > RGB_MATRIX_LED_COUNT) max = RGB_MATRIX_LED_COUNT
+
+#define RGB_MATRIX_TEST_LED_FLAGS() \
+    if (!HAS_ANY_FLAGS(g_led_config.flags[i], params->flags)) continue
+
+static inline bool rgb_matrix_check_finished_leds(uint8_t led_max) {
+    return led_max < RGB_MATRIX_LED_COUNT;
+}
+
+static rgb_t __attribute__((unused)) fake_leds[RGB_MATRIX_LED_COUNT];
+
+static inline void rgb_matrix_set_color(int index, uint8_t red, uint8_t green, uint8_t blue) {
+    fake_leds[index] = (rgb_t){.r = red, .g = green, .b = blue};
+}
@@ -0,0 +1,93 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/**
+ * \brief Minimal checks for the host tests.
+ *
+ * A failed check prints where and why and the test carries on, so one run
+ * shows every broken case.  `test_done` turns the count into the exit code.
+ */
+
+static int test_failures = 0;
+
+#define TEST_CHECK(cond, ...)                                \
+    do {                                                     \
+        if (!(cond)) {                                       \
+            test_failures++;                                 \
+            printf("%s:%d: %s: ", __FILE__, __LINE__, #cond); \
+            printf(__VA_ARGS__);                             \
+            printf("\n");                                    \
+        }                                                    \
+    } while (0)
+
+static inline int test_done(const char *name) {
+    printf("%s: %s\n", name, test_failures ? "FAILED" : "ok");
+    return test_failures ? 1 : 0;
+}
+
+/**
+ * \brief Compare `text` with the checked-in golden/`name`.
+ *
+ * With `GOLDEN_UPDATE=1` in the environment the file is rewritten instead,
+ * for a change that is meant to alter the output; review the diff.
+ */
+static inline void test_golden(const char *name, const char *text) {
+    char path[256];
+    snprintf(path, sizeof(path), "golden/%s", name);
+
+    const char *update = getenv("GOLDEN_UPDATE");
+    if (update && strcmp(update, "1") == 0) {
+        FILE *file = fopen(path, "w");
+        TEST_CHECK(file, "cannot write %s", path);
+        if (file) {
+            fputs(text, file);
+            fclose(file);
+        }
+        return;
+    }
+
+    static char golden[1 << 17];
+    FILE       *file = fopen(path, "r");
+    TEST_CHECK(file, "no %s, run with GOLDEN_UPDATE=1 to create it", path);
+    if (!file) {
+        return;
+    }
+    size_t length   = fread(golden, 1, sizeof(golden) - 1, file);
+    golden[length] = 0;
+    fclose(file);
+
+    if (strcmp(golden, text) == 0) {
+        return;
+    }
+    // Point at the first line that differs
+    size_t line = 1;
+    size_t i    = 0;
+    size_t start = 0;
+    for (; golden[i] && golden[i] == text[i]; i++) {
+        if (text[i] == '\n') {
+            line++;
+            start = i + 1;
+        }
+    }
+    TEST_CHECK(false, "%s:%zu differs: expected \"%.60s\", got \"%.60s\"", path, line, golden + start, text + start);
+}
@@ -0,0 +1,188 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// asym_debounce against QMK's default sym_defer_g on the same bounce
+// traces: how long after the contact each press and release is sent, and
+// which events were not keystrokes at all.
+
+#include "test.h"
+#include "../asym_debounce.c"
+
+#define SCAN_MS   1
+#define TRACE_END 400
+
+typedef struct {
+    uint8_t  key;
+    uint16_t down;   // ms the contact first closes.
+    uint16_t up;     // ms the contact first opens again.
+    uint8_t  bounce; // ms of chatter after each edge.
+    bool     noise;  // A glitch, not a keystroke: should not be sent at all.
+} keystroke_t;
+
+typedef struct {
+    const char       *name;
+    const keystroke_t strokes[8];
+    uint8_t           count;
+} trace_t;
+
+static const trace_t traces[] = {
+    {"clean tap", {{0, 10, 90, 0, false}}, 1},
+    {"bouncy tap", {{0, 10, 90, 3, false}}, 1},
+    // The next key lands while the last one's release still chatters
+    {"roll", {{0, 10, 60, 2, false}, {1, 58, 120, 2, false}}, 2},
+    {"fast typing", {{0, 10, 48, 2, false}, {6, 45, 83, 2, false}, {12, 80, 118, 2, false}, {18, 115, 153, 2, false}, {24, 150, 188, 2, false}, {30, 185, 223, 2, false}}, 6},
+    {"noise", {{0, 10, 200, 1, false}, {2, 60, 61, 0, true}}, 2},
+};
+
+// Contact state at `t`: closed from down, open from up, toggling every ms for `bounce` after each
+static bool contact(const keystroke_t *stroke, uint16_t t) {
+    if (t < stroke->down) {
+        return false;
+    }
+    if (t < stroke->down + stroke->bounce) {
+        return ((t - stroke->down) & 1) == 0;
+    }
+    if (t < stroke->up) {
+        return true;
+    }
+    if (t < stroke->up + stroke->bounce) {
+        return ((t - stroke->up) & 1) == 1;
+    }
+    return false;
+}
+
+// QMK's quantum/debounce/sym_defer_g.c: one timer for the whole matrix,
+// restarted by any change, and every key copied across once it runs out.
+static bool         sym_debouncing = false;
+static fast_timer_t sym_debouncing_time;
+
+static void sym_defer_g_init(uint8_t num_rows) {
+    sym_debouncing = false;
+}
+
+static bool sym_defer_g(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed) {
+    bool cooked_changed = false;
+    if (changed) {
+        sym_debouncing      = true;
+        sym_debouncing_time = timer_read_fast();
+    } else if (sym_debouncing && TIMER_DIFF_FAST(timer_read_fast(), sym_debouncing_time) >= DEBOUNCE) {
+        if (memcmp(cooked, raw, sizeof(matrix_row_t) * num_rows) != 0) {
+            memcpy(cooked, raw, sizeof(matrix_row_t) * num_rows);
+            cooked_changed = true;
+        }
+        sym_debouncing = false;
+    }
+    return cooked_changed;
+}
+
+typedef struct {
+    const char *name;
+    void (*init)(uint8_t num_rows);
+    bool (*run)(matrix_row_t raw[], matrix_row_t cooked[], uint8_t num_rows, bool changed);
+} algorithm_t;
+
+static const algorithm_t algorithms[] = {
+    {"asym", debounce_init, debounce},
+    {"sym_defer_g", sym_defer_g_init, sym_defer_g},
+};
+
+typedef struct {
+    uint32_t press_ms;   // Summed over the keystrokes, from first contact to sent.
+    uint32_t release_ms; // Summed, from the contact first opening to sent.
+    uint8_t  pressed;    // Keystrokes sent.
+    uint8_t  spurious;   // Presses sent that were not keystrokes, or a keystroke sent twice.
+} result_t;
+
+static result_t run_trace(const trace_t *trace, const algorithm_t *algorithm) {
+    matrix_row_t raw[MATRIX_ROWS]                = {0};
+    matrix_row_t cooked[MATRIX_ROWS]             = {0};
+    uint8_t      sent[MATRIX_ROWS * MATRIX_COLS] = {0};
+    result_t     result                          = {0};
+
+    fake_timer_ms = 1000; // Away from 0, so nothing relies on a zeroed timestamp.
+    algorithm->init(MATRIX_ROWS);
+    for (uint16_t t = 0; t < TRACE_END; t += SCAN_MS, fake_timer_advance(SCAN_MS)) {
+        matrix_row_t next[MATRIX_ROWS] = {0};
+        for (uint8_t i = 0; i < trace->count; i++) {
+            const keystroke_t *stroke = &trace->strokes[i];
+            if (contact(stroke, t)) {
+                next[stroke->key / MATRIX_COLS] |= (matrix_row_t)1 << (stroke->key % MATRIX_COLS);
+            }
+        }
+        bool changed = memcmp(raw, next, sizeof(raw)) != 0;
+        memcpy(raw, next, sizeof(raw));
+
+        matrix_row_t before[MATRIX_ROWS];
+        memcpy(before, cooked, sizeof(cooked));
+        algorithm->run(raw, cooked, MATRIX_ROWS, changed);
+
+        for (uint8_t i = 0; i < trace->count; i++) {
+            const keystroke_t *stroke = &trace->strokes[i];
+            uint8_t            row    = stroke->key / MATRIX_COLS;
+            matrix_row_t       bit    = (matrix_row_t)1 << (stroke->key % MATRIX_COLS);
+            if ((cooked[row] & bit) && !(before[row] & bit)) {
+                if (stroke->noise || sent[stroke->key]++) {
+                    result.spurious++;
+                } else {
+                    result.press_ms += t - stroke->down;
+                    result.pressed++;
+                }
+            }
+            if (!(cooked[row] & bit) && (before[row] & bit) && !stroke->noise) {
+                result.release_ms += t - stroke->up;
+            }
+        }
+    }
+    return result;
+}
+
+int main(void) {
+    printf("%-12s %-12s %9s %11s %8s\n", "trace", "debounce", "press ms", "release ms", "spurious");
+    for (uint8_t i = 0; i < ARRAY_SIZE(traces); i++) {
+        const trace_t *trace   = &traces[i];
+        uint8_t        strokes = 0;
+        for (uint8_t j = 0; j < trace->count; j++) {
+            strokes += !trace->strokes[j].noise;
+        }
+
+        result_t results[ARRAY_SIZE(algorithms)];
+        uint32_t flagged = 0;
+        for (uint8_t a = 0; a < ARRAY_SIZE(algorithms); a++) {
+            memset(&asym_debounce_stats, 0, sizeof(asym_debounce_stats));
+            results[a] = run_trace(trace, &algorithms[a]);
+            if (algorithms[a].run == debounce) {
+                flagged = asym_debounce_stats.spurious;
+            }
+            printf("%-12s %-12s %9.1f %11.1f %8u\n", a ? "" : trace->name, algorithms[a].name, (double)results[a].press_ms / strokes, (double)results[a].release_ms / strokes, results[a].spurious);
+            TEST_CHECK(results[a].pressed == strokes, "%s, %s: %u of %u keystrokes sent", trace->name, algorithms[a].name, results[a].pressed, strokes);
+        }
+
+        result_t *asym = &results[0];
+        result_t *sym  = &results[1];
+        // The point of asym: every press on the first scan that sees it
+        TEST_CHECK(asym->press_ms == 0, "%s: presses sent %u ms late", trace->name, asym->press_ms);
+        TEST_CHECK(asym->press_ms + DEBOUNCE * strokes <= sym->press_ms, "%s: presses not DEBOUNCE ahead of sym_defer_g", trace->name);
+        // Releases still wait out the chatter, never longer than sym_defer_g does
+        TEST_CHECK(asym->release_ms <= sym->release_ms, "%s: releases %u ms behind, sym_defer_g %u ms", trace->name, asym->release_ms, sym->release_ms);
+        TEST_CHECK(sym->spurious == 0, "%s: sym_defer_g sent %u spurious presses", trace->name, sym->spurious);
+
+        // The cost: a glitch is sent as a press, and the counters flag it
+        uint8_t glitches = strokes == trace->count ? 0 : 1;
+        TEST_CHECK(asym->spurious == glitches, "%s: asym sent %u spurious presses, expected %u", trace->name, asym->spurious, glitches);
+        TEST_CHECK(flagged == glitches, "%s: %u presses counted as noise, expected %u", trace->name, flagged, glitches);
+    }
+    return test_done("asym_debounce");
+}
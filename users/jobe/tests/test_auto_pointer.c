@@ -0,0 +1,75 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// auto_pointer: a bump of the ball shorter than the rejection window in
+// auto_pointer.h must not turn the layer on, however fast the ball moves
+// and however often it is read; a steady glide must.
+
+#include "test.h"
+
+#define LAYER_POINTER 4
+
+#include "../auto_pointer.c"
+
+// The rejection window auto_pointer.h gives for the defaults
+#define REJECT_MS 25
+
+// Let the layer time out and the energy drain
+static void rest(void) {
+    for (uint16_t ms = 0; ms < 2 * AUTO_POINTER_TIMEOUT_MS; ms++) {
+        fake_timer_advance(1);
+        fake_deferred_run();
+    }
+    layer_state = 0;
+}
+
+// Move the ball at `speed` counts a report, one report every `interval` ms,
+// for `duration` ms; true if the pointer layer came on
+static bool move(int8_t speed, uint16_t interval, uint16_t duration) {
+    rest();
+    bool on = false;
+    for (uint16_t ms = interval; ms <= duration; ms += interval) {
+        fake_timer_advance(interval);
+        fake_deferred_run();
+        report_mouse_t report = {.x = speed, .y = -speed};
+        auto_pointer_task(&report, LAYER_POINTER);
+        on |= get_highest_layer(layer_state) == LAYER_POINTER;
+    }
+    return on;
+}
+
+static void test_bumps(void) {
+    static const uint16_t intervals[] = {1, 2, 4, 8};
+    for (uint8_t i = 0; i < ARRAY_SIZE(intervals); i++) {
+        TEST_CHECK(!move(127, intervals[i], REJECT_MS), "a %u ms bump read every %u ms turned the layer on", REJECT_MS, intervals[i]);
+        // Reads further apart than the banked credit lose some of the rate
+        if (intervals[i] <= AUTO_POINTER_CREDIT_MS) {
+            TEST_CHECK(move(127, intervals[i], 2 * REJECT_MS), "a %u ms fling read every %u ms did not", 2 * REJECT_MS, intervals[i]);
+        }
+    }
+}
+
+static void test_glides(void) {
+    // Above E / T counts a ms the layer comes on, below it never does
+    TEST_CHECK(move(1, 1, 200), "a steady glide did not turn the layer on");
+    TEST_CHECK(!move(1, 8, 1000), "a crawl turned the layer on");
+}
+
+int main(void) {
+    test_bumps();
+    test_glides();
+    return test_done("auto_pointer");
+}
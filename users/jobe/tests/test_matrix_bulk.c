@@ -0,0 +1,179 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// matrix_bulk against a fake GPIO port wired like the Charybdis half: rows
+// pulled up, diodes from rows to columns, and rows that take a number of
+// reads to float back high after their column lets go.
+
+#include "test.h"
+
+#define MATRIX_ROW_PINS \
+    { 0, 1, 2, 3 }
+#define MATRIX_COL_PINS \
+    { 8, 9, 10, 11, 12 }
+#define MATRIX_BULK_RECOVER_SPINS 64
+
+#define MATRIX_BULK_READ_PORT()    fake_port_read()
+#define MATRIX_BULK_SELECT(mask)   fake_port_select(mask)
+#define MATRIX_BULK_UNSELECT(mask) fake_port_unselect(mask)
+#define MATRIX_BULK_PIN_BIT(pin)   ((uint32_t)1 << (pin))
+
+#include QMK_KEYBOARD_H
+
+#define FAKE_ROWS 4
+#define FAKE_COLS 5
+
+static uint8_t  fake_pressed[FAKE_ROWS]; // Columns held down, per row.
+static uint32_t fake_selected;           // Column port bits driven low.
+static uint16_t fake_lag;                // Reads a row stays low after its column is released.
+static uint16_t fake_low_reads[FAKE_ROWS];
+static uint32_t fake_reads;
+
+static uint32_t fake_port_read(void) {
+    uint32_t port = ~(uint32_t)0;
+    fake_reads++;
+    for (uint8_t row = 0; row < FAKE_ROWS; row++) {
+        bool low = false;
+        for (uint8_t col = 0; col < FAKE_COLS; col++) {
+            // Through the diode only: a key pulls its own row, never a neighbour's column
+            low |= (fake_pressed[row] & (1 << col)) && (fake_selected & (1u << (8 + col)));
+        }
+        if (fake_low_reads[row]) {
+            fake_low_reads[row]--;
+            low = true;
+        }
+        if (low) {
+            port &= ~(1u << row);
+        }
+    }
+    return port;
+}
+
+static void fake_port_select(uint32_t mask) {
+    fake_selected |= mask;
+}
+
+static void fake_port_unselect(uint32_t mask) {
+    for (uint8_t row = 0; row < FAKE_ROWS; row++) {
+        for (uint8_t col = 0; col < FAKE_COLS; col++) {
+            if ((mask & (1u << (8 + col))) && (fake_pressed[row] & (1 << col))) {
+                fake_low_reads[row] = fake_lag;
+            }
+        }
+    }
+    fake_selected &= ~mask;
+}
+
+#include "../../../keyboards/bastardkb/charybdis/3x5/keymaps/jobeod/matrix_bulk.c"
+
+static matrix_row_t scanned[ROWS_PER_HAND];
+
+static void fake_reset(uint16_t lag) {
+    memset(fake_pressed, 0, sizeof(fake_pressed));
+    memset(fake_low_reads, 0, sizeof(fake_low_reads));
+    memset(scanned, 0, sizeof(scanned));
+    memset(&matrix_bulk_stats, 0, sizeof(matrix_bulk_stats));
+    fake_selected     = 0;
+    fake_lag          = lag;
+    bulk_window_scans = 0;
+    matrix_init_custom();
+}
+
+static void check_scan(const char *name) {
+    matrix_scan_custom(scanned);
+    for (uint8_t row = 0; row < ROWS_PER_HAND; row++) {
+        TEST_CHECK(scanned[row] == fake_pressed[row], "%s: row %u read 0x%02x, held 0x%02x", name, row, scanned[row], fake_pressed[row]);
+    }
+}
+
+static void test_idle(void) {
+    fake_reset(20);
+    fake_reads = 0;
+    check_scan("idle");
+    // Nothing down: one read per column, no recovery polling
+    TEST_CHECK(fake_reads == FAKE_COLS, "idle scan took %u reads", fake_reads);
+    TEST_CHECK(matrix_bulk_stats.recover_worst == 0, "idle scan waited %u polls", matrix_bulk_stats.recover_worst);
+}
+
+static void test_no_ghosts(void) {
+    // Three corners of a rectangle, a full column and a full row: a scan
+    // that moved on before the rows recovered would smear them into the
+    // next column
+    for (uint16_t lag = 0; lag <= 40; lag += 10) {
+        fake_reset(lag);
+        fake_pressed[0] = 0x03;
+        fake_pressed[1] = 0x01;
+        check_scan("rectangle");
+
+        fake_pressed[0] = 0x04;
+        fake_pressed[1] = 0x04;
+        fake_pressed[2] = 0x04;
+        fake_pressed[3] = 0x04;
+        check_scan("column");
+
+        memset(fake_pressed, 0, sizeof(fake_pressed));
+        fake_pressed[2] = 0x1f;
+        check_scan("row");
+
+        fake_pressed[0] = 0x15;
+        fake_pressed[1] = 0x0a;
+        fake_pressed[2] = 0x15;
+        fake_pressed[3] = 0x0a;
+        check_scan("checkerboard");
+
+        memset(fake_pressed, 0, sizeof(fake_pressed));
+        check_scan("all released");
+    }
+}
+
+static void test_recovery(void) {
+    // The wait ends on the first read with the rows back high, not a fixed delay
+    for (uint16_t lag = 0; lag <= 40; lag += 5) {
+        fake_reset(lag);
+        fake_pressed[1] = 0x01;
+        fake_reads      = 0;
+        check_scan("recovery");
+        TEST_CHECK(matrix_bulk_stats.recover_worst == lag, "lag %u: waited %u polls", lag, matrix_bulk_stats.recover_worst);
+        TEST_CHECK(fake_reads == (uint32_t)FAKE_COLS + lag + 1, "lag %u: scan took %u reads", lag, fake_reads);
+    }
+
+    // Rows that never come back stop the wait at the bound.  The key is in
+    // the last column, so no other column is read through the stuck row
+    fake_reset(1000);
+    fake_pressed[0] = 0x10;
+    check_scan("stuck row");
+    TEST_CHECK(matrix_bulk_stats.recover_worst == MATRIX_BULK_RECOVER_SPINS, "stuck row: waited %u polls", matrix_bulk_stats.recover_worst);
+}
+
+static void test_rate(void) {
+    fake_reset(0);
+    for (uint16_t ms = 0; ms < 1500; ms++) {
+        matrix_scan_custom(scanned);
+        matrix_scan_custom(scanned);
+        fake_timer_advance(1);
+    }
+    TEST_CHECK(matrix_bulk_stats.scans == 3000, "%lu scans", (unsigned long)matrix_bulk_stats.scans);
+    // Two scans a ms, give or take the scan that closes the window
+    TEST_CHECK(matrix_bulk_stats.rate >= 1999 && matrix_bulk_stats.rate <= 2001, "rate %lu/s", (unsigned long)matrix_bulk_stats.rate);
+}
+
+int main(void) {
+    test_idle();
+    test_no_ghosts();
+    test_recovery();
+    test_rate();
+    return test_done("matrix_bulk");
+}
@@ -0,0 +1,129 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// pointer_accel: the carry neither loses nor reverses sub-count motion, in
+// either direction, and every curve only ever speeds up with the ball.
+
+#include "test.h"
+#include "../pointer_accel.c"
+
+static void reset_carry(void) {
+    pointer_accel_carry_x = 0;
+    pointer_accel_carry_y = 0;
+}
+
+// Feed `reports` identical deltas and return the sum of what came out
+static int32_t feed(int8_t delta, uint16_t reports, pointer_accel_curve_t curve, bool *reversed) {
+    int32_t total = 0;
+    for (uint16_t i = 0; i < reports; i++) {
+        report_mouse_t report = {.x = delta, .y = 0};
+        pointer_accel_task(&report, curve);
+        if ((delta > 0 && report.x < 0) || (delta < 0 && report.x > 0) || (delta == 0 && report.x != 0)) {
+            *reversed = true;
+        }
+        total += report.x;
+    }
+    return total;
+}
+
+// floor(a / 256), which `>>` only guarantees on this compiler
+static int32_t floor_q8(int32_t a) {
+    return a >= 0 ? a / 256 : -((-a + 255) / 256);
+}
+
+static void test_sub_count_conservation(void) {
+    for (pointer_accel_curve_t curve = 0; curve < POINTER_ACCEL_CURVE_COUNT; curve++) {
+        for (int8_t delta = -6; delta <= 6; delta++) {
+            reset_carry();
+            bool     reversed = false;
+            uint16_t reports  = 1000;
+            int32_t  total    = feed(delta, reports, curve, &reversed);
+
+            // A constant delta keeps the gain constant, so the total is exact up to the carry
+            uint16_t gain   = pointer_accel_curves[curve][abs(delta)];
+            int32_t  expect = floor_q8((int32_t)delta * gain * reports);
+            TEST_CHECK(total == expect, "curve %d delta %d: %d counts, expected %d", curve, delta, total, expect);
+            TEST_CHECK(!reversed, "curve %d delta %d: a report went the wrong way", curve, delta);
+        }
+    }
+}
+
+static void test_negative_matches_positive(void) {
+    for (pointer_accel_curve_t curve = 0; curve < POINTER_ACCEL_CURVE_COUNT; curve++) {
+        for (int8_t delta = 1; delta <= 40; delta++) {
+            bool reversed = false;
+            reset_carry();
+            int32_t forward = feed(delta, 333, curve, &reversed);
+            reset_carry();
+            int32_t backward = feed(-delta, 333, curve, &reversed);
+            // Flooring may round the two ways apart by the one count still in the carry
+            TEST_CHECK(abs(forward + backward) <= 1, "curve %d delta %d: +%d vs %d", curve, delta, forward, backward);
+            TEST_CHECK(!reversed, "curve %d delta %d: a report went the wrong way", curve, delta);
+        }
+    }
+}
+
+static void test_direction_change(void) {
+    // A full carry left over from moving right must not turn a slow move left into a step right
+    for (pointer_accel_curve_t curve = 0; curve < POINTER_ACCEL_CURVE_COUNT; curve++) {
+        for (int16_t carry = 0; carry < 256; carry++) {
+            pointer_accel_carry_x = carry;
+            report_mouse_t report = {.x = -1, .y = 0};
+            pointer_accel_task(&report, curve);
+            TEST_CHECK(report.x <= 0, "curve %d carry %d: -1 became %d", curve, carry, report.x);
+            TEST_CHECK(pointer_accel_carry_x >= 0 && pointer_accel_carry_x < 256, "curve %d: carry %d out of range", curve, pointer_accel_carry_x);
+        }
+    }
+}
+
+static void test_curves_monotonic(void) {
+    for (pointer_accel_curve_t curve = 0; curve < POINTER_ACCEL_CURVE_COUNT; curve++) {
+        for (uint8_t step = 1; step < POINTER_ACCEL_STEPS; step++) {
+            TEST_CHECK(pointer_accel_curves[curve][step] >= pointer_accel_curves[curve][step - 1], "curve %d step %u: gain drops", curve, step);
+        }
+
+        // Faster in, never slower out, with the carry taken out of the picture
+        int16_t last = -1;
+        for (int16_t delta = 0; delta <= INT8_MAX; delta++) {
+            reset_carry();
+            report_mouse_t report = {.x = delta, .y = 0};
+            pointer_accel_task(&report, curve);
+            TEST_CHECK(report.x >= last, "curve %d: %d counts in gives %d out, less than %d", curve, delta, report.x, last);
+            last = report.x;
+
+            reset_carry();
+            report_mouse_t mirror = {.x = -delta, .y = 0};
+            pointer_accel_task(&mirror, curve);
+            TEST_CHECK(-mirror.x - report.x >= 0 && -mirror.x - report.x <= 1, "curve %d: %d gives %d but %d gives %d", curve, delta, report.x, -delta, mirror.x);
+        }
+    }
+}
+
+static void test_clamped(void) {
+    reset_carry();
+    report_mouse_t report = {.x = INT8_MAX, .y = -INT8_MAX};
+    pointer_accel_task(&report, POINTER_ACCEL_DEFAULT);
+    TEST_CHECK(report.x == POINTER_ACCEL_XY_MAX && report.y == -POINTER_ACCEL_XY_MAX, "flick gave %d, %d", report.x, report.y);
+}
+
+int main(void) {
+    test_sub_count_conservation();
+    test_negative_matches_positive();
+    test_direction_change();
+    test_curves_monotonic();
+    test_clamped();
+    return test_done("pointer_accel");
+}
@@ -0,0 +1,140 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// pointer_replay through the pointer pipeline, in keymap.c's order: the
+// built-in stream and a recorded drag-scroll trace must print what the
+// goldens say, and nothing may be printed until the replay is over.
+
+#include "test.h"
+
+#define TAPPING_TERM 200
+#define DRAG_SCROLL_MOMENTUM
+#define LAYER_POINTER 4
+
+#include "../timing.c"
+#include "../auto_pointer.c"
+#include "../drag_scroll.c"
+#include "../pointer_accel.c"
+#include "../pointer_replay.c"
+
+#define RECORDED_SAMPLES 400
+
+static report_mouse_t last_input;
+
+// keymap.c's pointing_device_task_user, less the flick gesture and batching
+static void pipeline(report_mouse_t report) {
+    uint32_t start = pointer_replay_input(&report);
+    last_input     = report;
+    auto_pointer_task(&report, LAYER_POINTER);
+    drag_scroll_task(&report);
+    pointer_accel_task(&report, get_highest_layer(layer_state) == LAYER_POINTER ? POINTER_ACCEL_LINEAR : POINTER_ACCEL_DEFAULT);
+    pointer_replay_output(&report, start);
+}
+
+// One sensor read a ms, with deferred callbacks run in between like the main loop
+static void read_sensor(int8_t x, int8_t y) {
+    fake_timer_advance(1);
+    fake_deferred_run();
+    pipeline((report_mouse_t){.x = x, .y = y});
+}
+
+static void replay_key(bool pressed) {
+    keyrecord_t record = {.event = {.pressed = pressed, .time = timer_read()}};
+    pointer_replay_key(&record);
+}
+
+// Read the ball until the replay has played and printed; true if nothing
+// was printed while it played
+static bool run_replay(void) {
+    size_t started = fake_console_length;
+    while (replay_state == REPLAY_PLAYING) {
+        read_sensor(0, 0);
+    }
+    bool quiet = fake_console_length == started;
+    for (uint32_t ms = 0; replay_state == REPLAY_PRINTING && ms < 10 * POINTER_REPLAY_SAMPLES; ms++) {
+        read_sensor(0, 0);
+    }
+    TEST_CHECK(replay_state == REPLAY_IDLE, "still printing");
+    return quiet;
+}
+
+static void test_builtin(void) {
+    fake_console_length  = 0;
+    fake_console_capture = true;
+    replay_key(true);
+    read_sensor(0, 0);
+    replay_key(false);
+    TEST_CHECK(run_replay(), "printed while replaying");
+
+    // The flick is what should bring the auto pointer layer up
+    TEST_CHECK(strstr(fake_console, "replay: layer 0 -> 4") != NULL, "the flick did not turn the pointer layer on");
+    fake_console_capture = false;
+    test_golden("pointer_replay_builtin.txt", fake_console);
+
+    // Let the pointer layer time out before the next run
+    for (uint16_t ms = 0; ms < 2 * AUTO_POINTER_TIMEOUT_MS; ms++) {
+        read_sensor(0, 0);
+    }
+}
+
+// A slow circle, about two turns, as integer steps
+static int8_t trace_x(uint16_t i) {
+    static const int8_t steps[] = {3, 3, 2, 1, 0, -1, -2, -3, -3, -3, -2, -1, 0, 1, 2, 3};
+    return steps[(i / 12) % ARRAY_SIZE(steps)];
+}
+
+static int8_t trace_y(uint16_t i) {
+    return trace_x(i + 48);
+}
+
+static void test_recorded_drag_scroll(void) {
+    // Hold the key past the tapping term while the ball moves
+    replay_key(true);
+    for (uint16_t ms = 0; ms < TAPPING_TERM; ms++) {
+        read_sensor(5, 5); // Before the hold is decided: not recorded.
+    }
+    for (uint16_t i = 0; i < RECORDED_SAMPLES; i++) {
+        read_sensor(trace_x(i), trace_y(i));
+    }
+    fake_console_length  = 0;
+    fake_console_capture = true;
+    replay_key(false);
+    // The read that decided the hold is the first one kept
+    TEST_CHECK(replay_length == RECORDED_SAMPLES + 1, "recorded %u samples", replay_length);
+
+    // The replay feeds the recording, whatever the ball does meanwhile
+    size_t started = fake_console_length;
+    drag_scroll_set_enabled(true);
+    bool fed = true;
+    for (uint16_t i = 0; replay_state == REPLAY_PLAYING; i++) {
+        read_sensor(-20, 20);
+        if (i > 0 && i <= RECORDED_SAMPLES && (last_input.x != trace_x(i - 1) || last_input.y != trace_y(i - 1))) {
+            fed = false;
+        }
+    }
+    drag_scroll_set_enabled(false);
+    TEST_CHECK(fed, "the replay did not feed the recording");
+    TEST_CHECK(fake_console_length == started, "printed while replaying");
+    run_replay();
+    fake_console_capture = false;
+    test_golden("pointer_replay_recorded.txt", fake_console);
+}
+
+int main(void) {
+    test_builtin();
+    test_recorded_drag_scroll();
+    return test_done("pointer_replay");
+}
@@ -0,0 +1,259 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+// The custom effects of rgb_matrix_user.inc rendered on the host, frame by
+// frame as rgb_matrix would, for given layer, typing and tap/hold states.
+// Every scene is written out as a strip of frames, one PPM image, and
+// compared with its golden.  Host time per frame and redundant flushes are
+// printed per scene; the RP2040 figures come from RGB_BNCH.
+
+#include "test.h"
+
+#include <time.h>
+
+// One board drives both halves here; a process limit that divides the half
+// keeps every chunk on one side, as the split limits do on the keyboard.
+#define RGB_MATRIX_LED_PROCESS_LIMIT 6
+#include QMK_KEYBOARD_H
+
+// The keymap's config.h
+#define RGB_MATRIX_SPLIT \
+    { 18, 18 }
+#define RGB_KERNEL_CURRENT_LIMIT_MA 200
+#define LAYER_INDICATOR_KEY_CLASSES
+#define RGB_KERNEL_BENCH_ENABLE
+#define RGB_MATRIX_CUSTOM_EFFECT_IMPLS
+#define RGB_MATRIX_EFFECT(name)
+
+// Host nanoseconds stand in for cycles in the frame stats
+uint32_t timing_read_cycles(void) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint32_t)(now.tv_sec * 1000000000ull + now.tv_nsec);
+}
+
+uint32_t timing_cycles_since(uint32_t start) {
+    return timing_read_cycles() - start;
+}
+
+#include "../../../keyboards/jobe/charybdis/3x5x3/keymaps/jobe/rgb_kernels.c"
+#include "../../../keyboards/jobe/charybdis/3x5x3/keymaps/jobe/layer_indicator.c"
+#include "../../../keyboards/jobe/charybdis/3x5x3/keymaps/jobe/typing_heatmap.c"
+#include "../../../keyboards/jobe/charybdis/3x5x3/keymaps/jobe/tap_hold_stats.c"
+#include "../../../keyboards/jobe/charybdis/3x5x3/keymaps/jobe/rgb_matrix_user.inc"
+
+// Charybdis 3x5x3 wiring: three rows of five and three thumbs a half, the
+// right half on matrix rows 4 to 7, LEDs in the same order.
+#define HALF_LEDS 18
+#define NO_KEY    0
+
+led_config_t g_led_config = {
+    .matrix_co = {
+        {0, 1, 2, 3, 4},
+        {5, 6, 7, 8, 9},
+        {10, 11, 12, 13, 14},
+        {15, 16, 17, NO_LED, NO_LED},
+        {18, 19, 20, 21, 22},
+        {23, 24, 25, 26, 27},
+        {28, 29, 30, 31, 32},
+        {33, 34, 35, NO_LED, NO_LED},
+    },
+    .flags = {[0 ... RGB_MATRIX_LED_COUNT - 1] = LED_FLAG_KEYLIGHT},
+};
+
+const uint8_t PROGMEM layout_positions[MATRIX_ROWS][MATRIX_COLS] = {
+    {1, 2, 3, 4, 5},
+    {6, 7, 8, 9, 10},
+    {11, 12, 13, 14, 15},
+    {16, 17, 18, NO_KEY, NO_KEY},
+    {19, 20, 21, 22, 23},
+    {24, 25, 26, 27, 28},
+    {29, 30, 31, 32, 33},
+    {34, 35, 36, NO_KEY, NO_KEY},
+};
+
+// A navigation-like layer, by layout position: F keys along the left top
+// row, mods on the left home row, the cluster and arrows on the right
+#define LAYER_NAV 1
+const layer_key_masks_t PROGMEM layer_key_masks[] = {
+    [LAYER_NAV] = {
+        .bound = 0x207bd81ffULL, // The classes below and thumbs 16, 17 and 34
+        .mods  = 0x0000001e0ULL, // 6 to 9
+        .nav   = 0x007bc0000ULL, // 19 to 22 and 24 to 27
+        .fkeys = 0x00000001fULL, // 1 to 5
+    },
+};
+
+// Image strip: a half is five pixels wide with a dark column between the
+// halves, four rows a frame and a dark row between frames.
+#define STRIP_WIDTH  11
+#define FRAME_HEIGHT 5
+#define STRIP_FRAMES 12
+
+typedef struct {
+    const char *name;
+    bool (*effect)(effect_params_t *params);
+    rgb_t    pixels[STRIP_FRAMES * FRAME_HEIGHT][STRIP_WIDTH];
+    uint8_t  frames;
+    uint32_t ns_max;
+    uint32_t ns_total;
+} strip_t;
+
+static strip_t strip;
+
+static void strip_begin(const char *name, bool (*effect)(effect_params_t *params)) {
+    memset(&strip, 0, sizeof(strip));
+    strip.name       = name;
+    strip.effect     = effect;
+    rgb_kernel_bench = (rgb_kernel_bench_t){0};
+    memset(fake_leds, 0, sizeof(fake_leds));
+}
+
+// Run the effect's iterations for one frame, the way rgb_matrix_task does
+static void strip_frame(bool init) {
+    effect_params_t params = {.iter = 0, .flags = LED_FLAG_ALL, .init = init};
+    while (strip.effect(&params)) {
+        params.iter++;
+    }
+    strip.ns_total += rgb_kernel_bench.last;
+    if (rgb_kernel_bench.last > strip.ns_max) {
+        strip.ns_max = rgb_kernel_bench.last;
+    }
+
+    // The limiter's promise: no half over budget, whatever the effect drew
+    for (uint8_t first = 0; first < RGB_MATRIX_LED_COUNT; first += HALF_LEDS) {
+        uint32_t levels = 0;
+        for (uint8_t i = first; i < first + HALF_LEDS; i++) {
+            levels += fake_leds[i].r + fake_leds[i].g + fake_leds[i].b;
+        }
+        uint32_t budget = (RGB_KERNEL_CURRENT_LIMIT_MA - HALF_LEDS * RGB_KERNEL_IDLE_MA) * 255 / RGB_KERNEL_CHANNEL_MA;
+        TEST_CHECK(levels <= budget, "%s frame %u: half at %u levels, budget %u", strip.name, strip.frames, levels, budget);
+    }
+
+    for (uint8_t row = 0; row < MATRIX_ROWS; row++) {
+        for (uint8_t col = 0; col < MATRIX_COLS; col++) {
+            uint8_t led = g_led_config.matrix_co[row][col];
+            if (led == NO_LED) {
+                continue;
+            }
+            uint8_t x = row < MATRIX_ROWS / 2 ? col : MATRIX_COLS + 1 + col;
+            uint8_t y = strip.frames * FRAME_HEIGHT + row % (MATRIX_ROWS / 2);
+            strip.pixels[y][x] = fake_leds[led];
+        }
+    }
+    strip.frames++;
+}
+
+static void strip_end(void) {
+    static char text[1 << 16];
+    size_t      length = 0;
+    uint8_t     height = strip.frames * FRAME_HEIGHT - 1;
+    length += snprintf(text + length, sizeof(text) - length, "P3\n# %s, %u frames\n%u %u\n255\n", strip.name, strip.frames, STRIP_WIDTH, height);
+    for (uint8_t y = 0; y < height; y++) {
+        for (uint8_t x = 0; x < STRIP_WIDTH; x++) {
+            rgb_t pixel = strip.pixels[y][x];
+            length += snprintf(text + length, sizeof(text) - length, "%s%u %u %u", x ? "  " : "", pixel.r, pixel.g, pixel.b);
+        }
+        length += snprintf(text + length, sizeof(text) - length, "\n");
+    }
+
+    char file[64];
+    snprintf(file, sizeof(file), "rgb_%s.ppm", strip.name);
+    test_golden(file, text);
+    printf("%-18s %6u %12u %12u %10u\n", strip.name, strip.frames, strip.ns_total / strip.frames, strip.ns_max, rgb_kernel_bench.redundant);
+}
+
+static void press(uint8_t row, uint8_t col, bool pressed) {
+    keyrecord_t record = {.event = {.key = {.col = col, .row = row}, .pressed = pressed, .time = timer_read()}};
+    typing_heatmap_record(&record);
+}
+
+static void scene_solid_colors(void) {
+    // A home row mod held: one half flooded, at full brightness, so the limiter works
+    rgb_matrix_config.hsv = (hsv_t){HSV_TOKYO_BLUE};
+    rgb_matrix_config.hsv.v = RGB_MATRIX_MAXIMUM_BRIGHTNESS;
+    strip_begin("solid_color_left", SOLID_COLOR_LEFT);
+    strip_frame(true);
+    strip_frame(false);
+    strip_end();
+
+    rgb_matrix_config.hsv = (hsv_t){HSV_TOKYO_YELLOW};
+    strip_begin("solid_color_right", SOLID_COLOR_RIGHT);
+    strip_frame(true);
+    strip_frame(false);
+    strip_end();
+}
+
+static void scene_layer_indicator(void) {
+    rgb_matrix_config.hsv.v = RGB_MATRIX_MAXIMUM_BRIGHTNESS;
+    layer_indicator_set(LAYER_NAV, RGB_KERNEL_RGB(RGB_TOKYO_TEAL));
+    strip_begin("layer_indicator", LAYER_INDICATOR);
+    strip_frame(true);
+    strip_frame(false);
+    // Brightness down: the next frame is redrawn dimmer
+    rgb_matrix_config.hsv.v = RGB_MATRIX_MAXIMUM_BRIGHTNESS / 3;
+    strip_frame(false);
+    strip_end();
+    rgb_matrix_config.hsv.v = RGB_MATRIX_MAXIMUM_BRIGHTNESS;
+}
+
+static void scene_typing_heatmap(void) {
+    strip_begin("typing_heatmap", TYPING_HEATMAP);
+    strip_frame(true);
+    // A few keys across both halves, then one left key hammered
+    static const uint8_t keys[][2] = {{5, 0}, {1, 2}, {6, 3}, {6, 3}, {5, 3}, {1, 1}, {1, 1}, {1, 1}, {1, 1}};
+    for (uint8_t i = 0; i < ARRAY_SIZE(keys); i++) {
+        press(keys[i][0], keys[i][1], true);
+        fake_timer_advance(20);
+        press(keys[i][0], keys[i][1], false);
+        fake_timer_advance(40);
+    }
+    // Then watch it cool down
+    for (uint8_t frame = 0; frame < 8; frame++) {
+        strip_frame(false);
+        fake_timer_advance(400);
+    }
+    strip_end();
+}
+
+static void scene_tap_hold_latency(void) {
+    // Four home row mods, decided at once, early, late and on the tap term
+    static const uint8_t  keys[][2] = {{1, 0}, {1, 1}, {5, 3}, {5, 4}};
+    static const uint16_t waits[]   = {0, 40, 150, 250};
+    for (uint8_t key = 0; key < ARRAY_SIZE(keys); key++) {
+        // The running average takes a few decisions to settle
+        for (uint8_t repeat = 0; repeat < 16; repeat++) {
+            keyrecord_t record = {.event = {.key = {.col = keys[key][1], .row = keys[key][0]}, .pressed = true, .time = timer_read()}};
+            tap_hold_stats_press(key, &record);
+            fake_timer_advance(waits[key]);
+            tap_hold_stats_decide(key, 200);
+        }
+    }
+    strip_begin("tap_hold_latency", TAP_HOLD_LATENCY);
+    strip_frame(true);
+    strip_frame(false);
+    strip_end();
+}
+
+int main(void) {
+    fake_timer_ms = 1000;
+    printf("%-18s %6s %12s %12s %10s\n", "effect", "frames", "host ns mean", "host ns max", "redundant");
+    scene_solid_colors();
+    scene_layer_indicator();
+    scene_typing_heatmap();
+    scene_tap_hold_latency();
+    return test_done("rgb_effects");
+}
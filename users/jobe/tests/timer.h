@@ -0,0 +1,55 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * \brief Host clock for the tests: only moves when a test calls `fake_timer_advance`.
+ */
+
+static uint32_t fake_timer_ms = 0;
+
+static inline void fake_timer_advance(uint32_t ms) {
+    fake_timer_ms += ms;
+}
+
+static inline uint32_t timer_read32(void) {
+    return fake_timer_ms;
+}
+
+static inline uint16_t timer_read(void) {
+    return fake_timer_ms;
+}
+
+typedef uint32_t fast_timer_t;
+
+static inline fast_timer_t timer_read_fast(void) {
+    return fake_timer_ms;
+}
+
+static inline uint16_t timer_elapsed(uint16_t last) {
+    return (uint16_t)(fake_timer_ms - last);
+}
+
+static inline uint32_t timer_elapsed32(uint32_t last) {
+    return fake_timer_ms - last;
+}
+
+#define TIMER_DIFF_16(a, b)   ((uint16_t)((a) - (b)))
+#define TIMER_DIFF_FAST(a, b) ((uint32_t)((a) - (b)))
+#define timer_expired(current, future) ((uint16_t)((current) - (future)) < UINT16_MAX / 2)
@@ -0,0 +1,72 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "timing.h"
+#include "timer.h"
+
+#if defined(MCU_RP)
+#    include <hal.h>
+
+// SysTick is a 24-bit down-counter.
+#    define TIMING_SYSTICK_MASK 0x00FFFFFF
+
+static bool timing_systick_owned = false;
+#endif // MCU_RP
+
+void timing_init(void) {
+#if defined(MCU_RP)
+    if (timing_systick_owned) {
+        return;
+    }
+    // Don't steal SysTick if something else already runs it.
+    if (SysTick->CTRL & SysTick_CTRL_ENABLE_Msk) {
+        return;
+    }
+    SysTick->LOAD        = TIMING_SYSTICK_MASK;
+    SysTick->VAL         = 0;
+    SysTick->CTRL        = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_ENABLE_Msk;
+    timing_systick_owned = true;
+#endif // MCU_RP
+}
+
+uint32_t timing_read_us(void) {
+#if defined(MCU_RP)
+    return TIMER->TIMERAWL;
+#else
+    return timer_read32() * 1000;
+#endif // MCU_RP
+}
+
+uint32_t timing_read_cycles(void) {
+#if defined(MCU_RP)
+    if (timing_systick_owned) {
+        return TIMING_SYSTICK_MASK - SysTick->VAL;
+    }
+#endif // MCU_RP
+    return timing_read_us() * TIMING_CPU_MHZ;
+}
+
+uint32_t timing_cycles_since(uint32_t start) {
+    uint32_t elapsed = timing_read_cycles() - start;
+#if defined(MCU_RP)
+    if (timing_systick_owned) {
+        // Deltas are only valid for spans shorter than one SysTick wrap
+        // (~134 ms at 125 MHz), which is plenty for a frame or a callback.
+        elapsed &= TIMING_SYSTICK_MASK;
+    }
+#endif // MCU_RP
+    return elapsed;
+}
@@ -0,0 +1,44 @@
+/* Copyright 2024 Jobe
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+/**
+ * \brief High resolution timestamps for benchmarks and instrumentation.
+ *
+ * On the RP2040 the microsecond clock is the free-running 1 MHz TIMER
+ * peripheral, and cycles come from SysTick which the ChibiOS port leaves
+ * unused (the system tick runs off the TIMER alarms).  Other MCUs fall back
+ * to the millisecond timer, which is only good enough for coarse numbers.
+ */
+
+#ifndef TIMING_CPU_MHZ
+#    define TIMING_CPU_MHZ 125
+#endif // TIMING_CPU_MHZ
+
+/** Start the cycle counter.  Safe to call more than once. */
+void timing_init(void);
+
+/** Free-running microsecond timestamp, wraps every ~71 minutes. */
+uint32_t timing_read_us(void);
+
+/** Free-running cycle timestamp; only differences are meaningful. */
+uint32_t timing_read_cycles(void);
+
+/** Cycles elapsed since `start`, which must come from `timing_read_cycles`. */
+uint32_t timing_cycles_since(uint32_t start);